@@ -0,0 +1,206 @@
+#ifndef OOALLOC_H
+#define OOALLOC_H
+
+/**
+ * GG
+ * Per thread size class allocator for the small objects oogtk allocates
+ * at a high rate (callbacks and wrappers)
+ */
+
+#include <new>
+#include <vector>
+#include <stddef.h>
+#include <stdlib.h>
+#include "oomutex.h"
+
+namespace gtk {
+
+/** A small objects pool allocator.
+
+SmallPool serves blocks up to SmallPool::MaxSize bytes from per thread free lists, one for each 16 bytes size class, so that the allocation and the release of a callback or of a wrapper object is usually a couple of pointer operations without locks. Blocks are carved from 64KB chunks that are never given back to the system, they are recycled instead: a block released by a thread is reused by that thread, and the free lists of a terminated thread are handed to a global depot that the other threads draw from.
+
+Bigger requests are forwarded to the global operator new.
+
+The pool is used by the oogtk callbacks (every object derived from AbstractCbk, so the ones created by Object::callback(), Application::AddTimer(), Application::AddIdle() and ActionEntry) and by the wrappers derived from Object, if OOGTK_POOL_ALLOC is defined before including oogtk.h:
+
+\example
+#define OOGTK_POOL_ALLOC
+#include "oogtk.h"
+\endexample
+
+Signal callbacks are released when the object they are connected to is finalized, so when a toplevel window is destroyed all the callbacks of its widgets go back to the pool at once.
+*/
+class SmallPool
+{
+    public:
+        enum {
+            Granularity = 16 /**< size class step in bytes */,
+            MaxSize = 256 /**< biggest size served by the pool */,
+            Classes = MaxSize / Granularity,
+            ChunkSize = 64 * 1024
+        };
+
+        /// Allocates size bytes, throws std::bad_alloc on failure.
+        static void *Allocate(size_t size) {
+            if (size == 0)
+                size = 1;
+            if (size > MaxSize)
+                return ::operator new(size);
+
+            int cls = (int)((size - 1) / Granularity);
+
+            if (Cache *c = cache()) {
+                if (Block *b = c->free_[cls]) {
+                    c->free_[cls] = b->next;
+                    return b;
+                }
+                return refill(c, cls);
+            }
+            return global_allocate(cls);
+        }
+        /// Releases a block of size bytes obtained with SmallPool::Allocate().
+        static void Release(void *p, size_t size) {
+            if (!p)
+                return;
+            if (size == 0)
+                size = 1;
+            if (size > MaxSize) {
+                ::operator delete(p);
+                return;
+            }
+
+            int cls = (int)((size - 1) / Granularity);
+            Block *b = static_cast<Block *>(p);
+
+            if (Cache *c = cache()) {
+                b->next = c->free_[cls];
+                c->free_[cls] = b;
+            }
+            else {
+                AutoMutex lock(global().lock_);
+                b->next = global().depot_[cls];
+                global().depot_[cls] = b;
+            }
+        }
+
+/// DOXYS_OFF
+    private:
+        struct Block {
+            Block *next;
+        };
+        struct Cache {
+            Block *free_[Classes];
+            char *cur_, *end_;
+            Cache() : cur_(NULL), end_(NULL) {
+                for (int i = 0; i < Classes; ++i)
+                    free_[i] = NULL;
+            }
+        };
+        struct Global {
+            Mutex lock_;
+            Block *depot_[Classes];
+            std::vector<void *> chunks_;
+            Global() {
+                for (int i = 0; i < Classes; ++i)
+                    depot_[i] = NULL;
+            }
+        };
+        // gives back the free lists of a terminating thread to the depot
+        struct CacheGuard {
+            ~CacheGuard() {
+                Cache *&c = local();
+                if (!c)
+                    return;
+
+                AutoMutex lock(global().lock_);
+                for (int i = 0; i < Classes; ++i) {
+                    while (Block *b = c->free_[i]) {
+                        c->free_[i] = b->next;
+                        b->next = global().depot_[i];
+                        global().depot_[i] = b;
+                    }
+                }
+                delete c;
+                c = NULL;
+                dead() = true;
+            }
+        };
+
+        static Global &global() {
+            // never destroyed, blocks can be released after the static destructors ran
+            static Global *g = new Global();
+            return *g;
+        }
+        static Cache *&local() { static thread_local Cache *c = NULL; return c; }
+        static bool &dead() { static thread_local bool d = false; return d; }
+
+        static Cache *cache() {
+            Cache *&c = local();
+            if (!c && !dead()) {
+                static thread_local CacheGuard guard;
+                (void)guard;
+                c = new Cache();
+            }
+            return c;
+        }
+        static char *new_chunk() {
+            char *chunk = static_cast<char *>(malloc(ChunkSize));
+            if (!chunk)
+                throw std::bad_alloc();
+
+            AutoMutex lock(global().lock_);
+            global().chunks_.push_back(chunk);
+            return chunk;
+        }
+        static void *refill(Cache *c, int cls) {
+            size_t size = (cls + 1) * Granularity;
+
+            if (c->cur_ + size <= c->end_) {
+                void *p = c->cur_;
+                c->cur_ += size;
+                return p;
+            }
+            {
+                AutoMutex lock(global().lock_);
+                if (Block *b = global().depot_[cls]) {
+                    // take the whole list, the next allocations will be served locally
+                    global().depot_[cls] = NULL;
+                    c->free_[cls] = b->next;
+                    return b;
+                }
+            }
+            c->cur_ = new_chunk();
+            c->end_ = c->cur_ + ChunkSize;
+            void *p = c->cur_;
+            c->cur_ += size;
+            return p;
+        }
+        // used only by threads whose cache has already been destroyed
+        static void *global_allocate(int cls) {
+            {
+                AutoMutex lock(global().lock_);
+                if (Block *b = global().depot_[cls]) {
+                    global().depot_[cls] = b->next;
+                    return b;
+                }
+            }
+            return ::operator new((cls + 1) * Granularity);
+        }
+/// DOXYS_ON
+};
+
+}
+
+/// DOXYS_OFF
+// class level operators routing the allocations of a class hierarchy to the SmallPool,
+// the sized delete receives the size of the dynamic type thanks to the virtual destructors.
+#ifdef OOGTK_POOL_ALLOC
+#define OOGTK_POOLED \
+            static void *operator new(size_t size) { return gtk::SmallPool::Allocate(size); } \
+            static void operator delete(void *p, size_t size) { gtk::SmallPool::Release(p, size); }
+#else
+#define OOGTK_POOLED
+#endif
+/// DOXYS_ON
+
+#endif
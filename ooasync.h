@@ -0,0 +1,575 @@
+#ifndef OOASYNC_H
+#define OOASYNC_H
+
+/**
+ * GG
+ * Staged construction of big interfaces and models: the expensive work is
+ * done by a worker thread, the main loop only attaches the results in
+ * small time slices.
+ */
+
+#include "oogtk.h"
+#include "oothread.h"
+#include <set>
+#include <map>
+#include <string.h>
+
+namespace gtk {
+
+/** Base class for the staged loaders.
+
+An AsyncLoader splits a long operation in two stages, AsyncLoader::prepare() runs in a worker thread and must not touch any GTK object, AsyncLoader::attach() runs in the main loop, inside an idle handler, and is called repeatedly until it reports that all the work has been attached. Every call of attach() should do only the amount of work that fits in AsyncLoader::Slice() milliseconds, so that the main loop can keep redrawing the windows and processing the user input while the loader is working.
+
+Progress is reported through the callback set with AsyncLoader::OnProgress(), that is always called in the main loop context, the last call has AsyncLoader::Finished() returning true.
+*/
+    class AsyncLoader : public Thread
+    {
+/// DOXYS_OFF
+            struct AbstractProgress {
+                virtual ~AbstractProgress() {}
+                virtual void notify(AsyncLoader &) const = 0;
+            };
+            template <typename T>
+            struct ProgressCbk : public AbstractProgress {
+                T *myObj;
+                void (T::*myFnc)(AsyncLoader &);
+                ProgressCbk(T *obj, void (T::*fnc)(AsyncLoader &)) : myObj(obj), myFnc(fnc) {}
+                void notify(AsyncLoader &l) const { (myObj->*myFnc)(l); }
+            };
+
+            AbstractProgress *progress_;
+            Mutex lock_;
+            guint idle_;
+            int slice_;
+            bool finished_;
+
+            static gboolean idle_cbk(AsyncLoader *l) {
+                gint64 deadline = g_get_monotonic_time() + l->slice_ * G_TIME_SPAN_MILLISECOND;
+                bool more = l->error_.empty() && l->attach(deadline);
+
+                if (!more) {
+                    AutoMutex lock(l->lock_);
+                    l->idle_ = 0;
+                    l->finished_ = true;
+                }
+                if (l->progress_)
+                    l->progress_->notify(*l);
+
+                return more ? TRUE : FALSE;
+            }
+            void worker_thread() {
+                if (!prepare() && error_.empty())
+                    error_ = "loader interrupted";
+
+                AutoMutex lock(lock_);
+                if (Running())
+                    idle_ = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, GSourceFunc(idle_cbk), this, NULL);
+            }
+/// DOXYS_ON
+        protected:
+            std::string error_;
+            int loaded_;
+            int total_;
+
+            /// The worker stage, runs in a separate thread. It should check Thread::Running() periodically and return false if the thread has been terminated.
+            virtual bool prepare() = 0;
+            /// The main loop stage, attach as much work as possible before deadline (a g_get_monotonic_time() value), return false when all the work has been attached.
+            virtual bool attach(gint64 deadline) = 0;
+            /** Stops the worker and removes the pending main loop slices.
+
+It must be called by the destructor of every derived class, since the worker may still be using the derived class data: Thread::Running() becomes false and Stop() waits for prepare() to return, however long it takes.
+            */
+            void Stop() {
+                Cancel();
+                Join();
+
+                AutoMutex lock(lock_);
+                if (idle_) {
+                    g_source_remove(idle_);
+                    idle_ = 0;
+                }
+            }
+        public:
+            AsyncLoader(const std::string &name) : Thread(name), progress_(NULL), idle_(0), slice_(8),
+                                                   finished_(false), loaded_(0), total_(0) {}
+            virtual ~AsyncLoader() {
+                Stop();
+                delete progress_;
+            }
+
+            /// Sets the maximum amount of milliseconds every main loop slice may last, defaults to 8ms.
+            void Slice(int msecs) { slice_ = msecs > 0 ? msecs : 1; }
+            /// Returns the duration of a main loop slice in milliseconds.
+            int Slice() const { return slice_; }
+            /// Returns the number of work units already attached in the main loop.
+            int Done() const { return loaded_; }
+            /// Returns the total number of work units, it's meaningful only after the first progress notification.
+            int Total() const { return total_; }
+            /// Returns true if the loader completed, with or without errors.
+            bool Finished() const { return finished_; }
+            /// Returns the error that stopped the loader, an empty string if there is no error.
+            const std::string &Error() const { return error_; }
+
+            /// Sets the method that will be notified, in the main loop, after every attached slice.
+            template <typename T>
+            void OnProgress(void (T::*cbk)(AsyncLoader &), T *base) {
+                delete progress_;
+                progress_ = new ProgressCbk<T>(base, cbk);
+            }
+    };
+
+/** Loads a Builder interface in the background.
+
+The worker thread reads the UI definition and splits it in independent fragments, one for every toplevel object of the definition, ordered so that every object is built after the objects it refers to. The main loop then merges the fragments in the Builder one at a time, in slices of at most AsyncLoader::Slice() milliseconds, so big interfaces don't freeze the application and the first windows can be shown as soon as they are built.
+
+If the references between the toplevel objects contain a cycle the whole interface is loaded in a single step.
+
+\example
+class MyApp : public gtk::Application, public gtk::Builder {
+    gtk::AsyncBuilder loader_;
+    gtk::ProgressBar bar_;
+public:
+    MyApp() : loader_(*this, "huge.ui") {
+        loader_.OnProgress(&MyApp::progress, this);
+    }
+    void progress(gtk::AsyncLoader &l) {
+        if (!l.Finished())
+            bar_.Fraction(double(l.Done()) / l.Total());
+        else if (l.Error().empty())
+            Get<gtk::Window>("main_window")->ShowAll();
+    }
+};
+\endexample
+*/
+    class AsyncBuilder : public AsyncLoader
+    {
+/// DOXYS_OFF
+            Builder &builder_;
+            std::string ui_;
+            Builder::BuildSource source_;
+            std::vector<std::string> fragments_;
+
+            struct Toplevel {
+                size_t begin, end;
+                std::set<std::string> refs;
+            };
+
+            static size_t skip_to(const std::string &xml, size_t pos, const char *end) {
+                size_t e = xml.find(end, pos);
+                return e == std::string::npos ? std::string::npos : e + strlen(end);
+            }
+            static std::string attribute(const std::string &tag, const char *name) {
+                std::string key = std::string(name) + "=";
+                size_t pos = 0;
+
+                while ((pos = tag.find(key, pos)) != std::string::npos) {
+                    if (pos > 0 && !g_ascii_isspace(tag[pos - 1])) {
+                        pos += key.length();
+                        continue;
+                    }
+                    pos += key.length();
+                    if (pos >= tag.length() || (tag[pos] != '"' && tag[pos] != '\''))
+                        break;
+                    size_t end = tag.find(tag[pos], pos + 1);
+                    if (end == std::string::npos)
+                        break;
+                    return tag.substr(pos + 1, end - pos - 1);
+                }
+                return "";
+            }
+            static std::string trim(const std::string &s) {
+                size_t b = s.find_first_not_of(" \t\r\n"), e = s.find_last_not_of(" \t\r\n");
+                return b == std::string::npos ? "" : s.substr(b, e - b + 1);
+            }
+
+            // split the interface in a list of toplevel fragments, returns false if the
+            // interface cannot be split (the caller will then load it as a whole).
+            bool split(const std::string &xml) {
+                std::vector<Toplevel> tops;
+                std::map<std::string, size_t> owner; // object id -> toplevel index
+                std::string open, header;
+                std::vector<std::string> stack;
+                std::string text;
+                bool in_property = false;
+                size_t pos = 0, top_begin = 0;
+
+                while ((pos = xml.find('<', pos)) != std::string::npos) {
+                    if (!Running())
+                        return false;
+
+                    if (xml.compare(pos, 4, "<!--") == 0) {
+                        pos = skip_to(xml, pos, "-->");
+                        continue;
+                    }
+                    if (xml.compare(pos, 9, "<![CDATA[") == 0) {
+                        size_t end = skip_to(xml, pos, "]]>");
+                        if (in_property && end != std::string::npos)
+                            text.append(xml, pos + 9, end - pos - 12);
+                        pos = end;
+                        continue;
+                    }
+                    if (xml.compare(pos, 2, "<?") == 0) {
+                        pos = skip_to(xml, pos, "?>");
+                        continue;
+                    }
+                    if (xml.compare(pos, 2, "<!") == 0) {
+                        pos = skip_to(xml, pos, ">");
+                        continue;
+                    }
+
+                    // find the end of the tag, skipping quoted attribute values
+                    size_t end = pos + 1;
+                    char quote = 0;
+                    for (; end < xml.length(); ++end) {
+                        if (quote) {
+                            if (xml[end] == quote)
+                                quote = 0;
+                        }
+                        else if (xml[end] == '"' || xml[end] == '\'')
+                            quote = xml[end];
+                        else if (xml[end] == '>')
+                            break;
+                    }
+                    if (end >= xml.length())
+                        return false;
+
+                    std::string tag = xml.substr(pos, end - pos + 1);
+                    size_t next = end + 1;
+
+                    if (tag[1] == '/') {
+                        if (stack.empty())
+                            return false;
+                        if (stack.back() == "property" && in_property) {
+                            in_property = false;
+                            std::string ref = trim(text);
+                            if (!ref.empty() && !tops.empty())
+                                tops.back().refs.insert(ref);
+                        }
+                        stack.pop_back();
+                        if (stack.size() == 1) {
+                            if (tops.empty() || tops.back().end != std::string::npos)
+                                header += xml.substr(top_begin, next - top_begin);
+                            else
+                                tops.back().end = next;
+                        }
+                    }
+                    else {
+                        bool closed = tag[tag.length() - 2] == '/';
+                        size_t n = 1;
+                        while (n < tag.length() && !g_ascii_isspace(tag[n]) && tag[n] != '/' && tag[n] != '>')
+                            ++n;
+                        std::string name = tag.substr(1, n - 1);
+
+                        if (stack.empty()) {
+                            if (name != "interface")
+                                return false;
+                            open = tag;
+                        }
+                        else {
+                            if (stack.size() == 1) {
+                                top_begin = pos;
+                                if (name == "object") {
+                                    Toplevel t;
+                                    t.begin = pos;
+                                    t.end = closed ? next : std::string::npos;
+                                    tops.push_back(t);
+                                }
+                                else if (closed)
+                                    header += tag;
+                            }
+                            if (name == "object" && !tops.empty()) {
+                                std::string id = attribute(tag, "id");
+                                if (!id.empty())
+                                    owner[id] = tops.size() - 1;
+                            }
+                            else if (name == "signal" && !tops.empty()) {
+                                std::string obj = attribute(tag, "object");
+                                if (!obj.empty())
+                                    tops.back().refs.insert(obj);
+                            }
+                            else if (name == "widget" && !tops.empty()) {
+                                std::string w = attribute(tag, "name");
+                                if (!w.empty())
+                                    tops.back().refs.insert(w);
+                            }
+                            else if (name == "property" && !closed) {
+                                in_property = true;
+                                text.clear();
+                            }
+                        }
+                        if (!closed)
+                            stack.push_back(name);
+                    }
+
+                    // collect the text following the tag if we are inside a property
+                    if (in_property) {
+                        size_t lt = xml.find('<', next);
+                        if (lt == std::string::npos)
+                            return false;
+                        text.append(xml, next, lt - next);
+                    }
+                    pos = next;
+                }
+                if (!stack.empty() || open.empty())
+                    return false;
+
+                // topological sort of the toplevels, every reference must be built first
+                std::vector<int> state(tops.size(), 0); // 0 new, 1 visiting, 2 done
+                std::vector<size_t> order;
+
+                for (size_t i = 0; i < tops.size(); ++i)
+                    if (!visit(i, tops, owner, state, order))
+                        return false;
+
+                for (size_t i = 0; i < order.size(); ++i) {
+                    const Toplevel &t = tops[order[i]];
+                    fragments_.push_back(open + header + xml.substr(t.begin, t.end - t.begin) + "</interface>");
+                }
+                return true;
+            }
+            bool visit(size_t i, const std::vector<Toplevel> &tops, const std::map<std::string, size_t> &owner,
+                       std::vector<int> &state, std::vector<size_t> &order) {
+                if (state[i] == 2)
+                    return true;
+                if (state[i] == 1)
+                    return false; // cycle
+
+                state[i] = 1;
+                for (std::set<std::string>::const_iterator it = tops[i].refs.begin(); it != tops[i].refs.end(); ++it) {
+                    std::map<std::string, size_t>::const_iterator o = owner.find(*it);
+                    if (o != owner.end() && o->second != i && !visit(o->second, tops, owner, state, order))
+                        return false;
+                }
+                state[i] = 2;
+                order.push_back(i);
+                return true;
+            }
+/// DOXYS_ON
+        protected:
+            bool prepare() {
+                std::string xml;
+
+                if (source_ == Builder::File) {
+                    gchar *contents = NULL;
+                    gsize length = 0;
+                    GError *err = NULL;
+
+                    if (!g_file_get_contents(ui_.c_str(), &contents, &length, &err)) {
+                        error_ = err ? err->message : "unable to read " + ui_;
+                        if (err)
+                            g_error_free(err);
+                        return true;
+                    }
+                    xml.assign(contents, length);
+                    g_free(contents);
+                }
+                else
+                    xml.swap(ui_);
+
+                if (!split(xml)) {
+                    if (!Running())
+                        return false;
+                    fragments_.clear();
+                    fragments_.push_back(xml);
+                }
+                total_ = fragments_.size();
+                return true;
+            }
+            bool attach(gint64 deadline) {
+                do {
+                    if (loaded_ >= total_)
+                        return false;
+                    if (!builder_.Load(fragments_[loaded_], Builder::String)) {
+                        error_ = builder_.Error();
+                        return false;
+                    }
+                    std::string().swap(fragments_[loaded_++]);
+                } while (g_get_monotonic_time() < deadline);
+
+                return loaded_ < total_;
+            }
+        public:
+            /// Starts loading an interface in builder, builder must outlive the AsyncBuilder object.
+            AsyncBuilder(Builder &builder /**< the Builder that will receive the objects */,
+                         const std::string &ui /**< the filename of the builder interface to load or a string containing an interface definition, as specified by the second parameter */,
+                         Builder::BuildSource source = Builder::File /**< specify what kind of objects the second parameter points to, defaults to Builder::File */) :
+                AsyncLoader("async builder"), builder_(builder), ui_(ui), source_(source) {
+                Start();
+            }
+            ~AsyncBuilder() { Stop(); }
+    };
+
+/** A table of rows prepared outside the main loop.
+
+A RowBuffer stores the values of the rows of a ListStore as GValues of the column types, so the conversion of the data (number formatting, string building...) can be done by a worker thread, leaving only the insertion to the main loop.
+
+\sa AsyncListLoader
+*/
+    class RowBuffer
+    {
+/// DOXYS_OFF
+            TypeList types_;
+            std::vector<GValue> values_;
+            size_t rows_;
+
+            GValue *cell(int col) {
+                if (!rows_ || col < 0 || col >= (int)types_.size())
+                    throw std::runtime_error("RowBuffer: invalid column or no current row");
+                return &values_[(rows_ - 1) * types_.size() + col];
+            }
+            RowBuffer(const RowBuffer &);
+            RowBuffer &operator=(const RowBuffer &);
+/// DOXYS_ON
+        public:
+            /// Creates an empty buffer for rows with the given column types.
+            RowBuffer(const TypeList &types) : types_(types), rows_(0) {}
+            ~RowBuffer() { Clear(); }
+
+            /// Appends a new row, with default values, that becomes the current row for RowBuffer::Set().
+            void AddRow() {
+                size_t cols = types_.size();
+                GValue zero;
+                memset(&zero, 0, sizeof(zero));
+                values_.resize((rows_ + 1) * cols, zero);
+                for (size_t i = 0; i < cols; ++i)
+                    g_value_init(&values_[rows_ * cols + i], types_[i]);
+                ++rows_;
+            }
+            /// Sets a column of the current row, the value is converted to the column type.
+            void Set(int col, int value) { RowValues::Store(cell(col), value); }
+            void Set(int col, double value) { RowValues::Store(cell(col), value); }
+            void Set(int col, bool value) { RowValues::Store(cell(col), value); }
+            void Set(int col, const std::string &value) { RowValues::Store(cell(col), value.c_str()); }
+            void Set(int col, const char *value) { RowValues::Store(cell(col), value); }
+            /// Sets a pointer or a GObject column (a Pixbuf for instance) of the current row.
+            void Set(int col, void *value) { RowValues::Store(cell(col), value); }
+            /// Returns the number of rows in the buffer.
+            size_t Rows() const { return rows_; }
+            /// Returns the number of columns of every row.
+            size_t Columns() const { return types_.size(); }
+            /// Returns the column types.
+            const TypeList &Types() const { return types_; }
+            /// Returns a pointer to the values of a row, suitable for gtk_list_store_insert_with_valuesv().
+            GValue *Row(size_t row) { return &values_[row * types_.size()]; }
+            /// Releases the values of a row, to free memory as soon as it has been inserted in a model.
+            void Release(size_t row) {
+                GValue *v = Row(row);
+                for (size_t i = 0; i < types_.size(); ++i)
+                    if (G_IS_VALUE(&v[i]))
+                        g_value_unset(&v[i]);
+            }
+            /// Removes all the rows.
+            void Clear() {
+                for (size_t i = 0; i < rows_; ++i)
+                    Release(i);
+                values_.clear();
+                rows_ = 0;
+            }
+    };
+
+/** Fills a ListStore with rows prepared by a worker thread.
+
+The filler method is called in a separate thread with an empty RowBuffer matching the column types of the ListStore, it must not touch any GTK object. Once it returns the rows are appended to the store in the main loop, in slices of at most AsyncLoader::Slice() milliseconds.
+
+The destructor waits for the filler to return, a filler that takes long should receive the loader too and return as soon as Thread::Running() is false.
+
+\example
+void MyApp::fill(gtk::RowBuffer &rows, gtk::AsyncListLoader &loader) { // runs in the worker thread
+    for (size_t i = 0; i < records_.size() && loader.Running(); ++i) {
+        rows.AddRow();
+        rows.Set(0, records_[i].name);
+        rows.Set(1, records_[i].price);
+    }
+}
+...
+loader_ = new gtk::AsyncListLoader(store_, &MyApp::fill, this);
+\endexample
+*/
+    class AsyncListLoader : public AsyncLoader
+    {
+/// DOXYS_OFF
+            struct AbstractFill {
+                virtual ~AbstractFill() {}
+                virtual void fill(RowBuffer &, AsyncListLoader &) const = 0;
+            };
+            template <typename T>
+            struct FillCbk : public AbstractFill {
+                T *myObj;
+                void (T::*myFnc0)(RowBuffer &);
+                void (T::*myFnc1)(RowBuffer &, AsyncListLoader &);
+                FillCbk(T *obj, void (T::*fnc)(RowBuffer &)) : myObj(obj), myFnc0(fnc), myFnc1(NULL) {}
+                FillCbk(T *obj, void (T::*fnc)(RowBuffer &, AsyncListLoader &)) : myObj(obj), myFnc0(NULL), myFnc1(fnc) {}
+                void fill(RowBuffer &r, AsyncListLoader &l) const {
+                    if (myFnc1)
+                        (myObj->*myFnc1)(r, l);
+                    else
+                        (myObj->*myFnc0)(r);
+                }
+            };
+
+            static TypeList column_types(GtkTreeModel *m) {
+                TypeList types;
+                for (int i = 0; i < gtk_tree_model_get_n_columns(m); ++i)
+                    types.push_back(gtk_tree_model_get_column_type(m, i));
+                return types;
+            }
+
+            ListStore &store_;
+            AbstractFill *filler_;
+            RowBuffer rows_;
+            std::vector<gint> columns_;
+
+            void init() {
+                for (size_t i = 0; i < rows_.Columns(); ++i)
+                    columns_.push_back(i);
+                Start();
+            }
+/// DOXYS_ON
+        protected:
+            bool prepare() {
+                filler_->fill(rows_, *this);
+                total_ = rows_.Rows();
+                return Running();
+            }
+            bool attach(gint64 deadline) {
+                while (loaded_ < total_) {
+                    // check the clock every 64 rows
+                    for (int i = 0; i < 64 && loaded_ < total_; ++i, ++loaded_) {
+                        TreeIter it;
+                        gtk_list_store_insert_with_valuesv(store_, &it, -1, &columns_[0], rows_.Row(loaded_), columns_.size());
+                        rows_.Release(loaded_);
+                    }
+                    if (g_get_monotonic_time() >= deadline)
+                        break;
+                }
+                if (loaded_ >= total_)
+                    rows_.Clear();
+                return loaded_ < total_;
+            }
+        public:
+            /// Starts loading rows in store, store must outlive the AsyncListLoader object.
+            template <typename T>
+            AsyncListLoader(ListStore &store /**< the store that will receive the rows */,
+                            void (T::*fill)(RowBuffer &) /**< the method that fills the RowBuffer, called in the worker thread */,
+                            T *base /**< the object the method belongs to */) :
+                AsyncLoader("async list loader"), store_(store), filler_(new FillCbk<T>(base, fill)),
+                rows_(column_types(store)) {
+                init();
+            }
+            /// Starts loading rows in store, the filler receives the loader too, to check AsyncLoader::Running() and stop early.
+            template <typename T>
+            AsyncListLoader(ListStore &store /**< the store that will receive the rows */,
+                            void (T::*fill)(RowBuffer &, AsyncListLoader &) /**< the method that fills the RowBuffer, called in the worker thread */,
+                            T *base /**< the object the method belongs to */) :
+                AsyncLoader("async list loader"), store_(store), filler_(new FillCbk<T>(base, fill)),
+                rows_(column_types(store)) {
+                init();
+            }
+            ~AsyncListLoader() {
+                Stop();
+                delete filler_;
+            }
+    };
+}
+
+#endif
@@ -92,6 +92,8 @@ public:
     Context(const Surface &s) { c_ = cairo_create(s); }
     /// Creates a new cairo context width a widget as destination
     Context(const gtk::Widget &w) { c_ = gdk_cairo_create(w);  }
+    /// Creates a new cairo context with a GdkDrawable as destination
+    Context(GdkDrawable *d) { c_ = gdk_cairo_create(d); }
     ~Context() { cairo_destroy(c_); }
 
     // context handling
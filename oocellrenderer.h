@@ -0,0 +1,210 @@
+#ifndef OOCELLRENDERER_H
+#define OOCELLRENDERER_H
+
+/**
+ * GG
+ * A cell renderer implemented in C++, drawing its cells with cairo.
+ */
+
+#include "ootree.h"
+#include "oocairo.h"
+#include <string.h>
+#include <type_traits>
+
+namespace gtk {
+
+/** A cell renderer drawing its cells with cairo::Context.
+
+CustomCellRenderer is a GtkCellRenderer subclass whose size and drawing are delegated to the virtual methods GetSize() and Render(), so sparklines, mini bar charts or any other small graphic can be drawn directly in the cells of a TreeView, without building a pixbuf for every row.
+
+The renderer must outlive the views it's packed in, usually it's a member of the object owning the view. The value of a model column is copied in the renderer before every cell is drawn with Bind(), Value() returns it to Render(); for more complex rows TreeViewColumn::CellData() can be used to set the state of the renderer directly.
+
+\example
+class Bar : public gtk::CustomCellRenderer
+{
+    void GetSize(GtkWidget *, int &width, int &height) { width = 80; height = 12; }
+    void Render(cairo::Context &cr, const gtk::Rect &area) {
+        cr.rectangle(area.x, area.y, area.width * Value<double>(), area.height);
+        cr.source_rgb(Selected() ? "#ffffff" : "#3465a4");
+        cr.fill();
+    }
+};
+...
+column.PackStart(bar);
+bar.Bind(column, 2);
+tv.Append(column);
+\endexample
+
+\note The padding and the alignment of the renderer are applied by CustomCellRenderer, GetSize() returns the size of the content only and the area passed to Render() excludes the padding.
+*/
+    class CustomCellRenderer : public CellRenderer
+    {
+/// DOXYS_OFF
+        private:
+            struct Instance {
+                GtkCellRenderer parent;
+                CustomCellRenderer *self;
+            };
+            struct Class {
+                GtkCellRendererClass parent;
+            };
+
+            GValue value_;
+            guint flags_;
+
+            static CustomCellRenderer *self(GtkCellRenderer *cell) { return reinterpret_cast<Instance *>(cell)->self; }
+
+            static void get_size(GtkCellRenderer *cell, GtkWidget *widget, GdkRectangle *cell_area,
+                                 gint *x_offset, gint *y_offset, gint *width, gint *height) {
+                gint w, h, xpad, ypad;
+                gfloat xalign, yalign;
+
+                gtk_cell_renderer_get_fixed_size(cell, &w, &h);
+                if (w < 0) w = 0;
+                if (h < 0) h = 0;
+                if (CustomCellRenderer *r = self(cell))
+                    r->GetSize(widget, w, h);
+
+                gtk_cell_renderer_get_padding(cell, &xpad, &ypad);
+                gtk_cell_renderer_get_alignment(cell, &xalign, &yalign);
+                w += xpad * 2;
+                h += ypad * 2;
+
+                if (cell_area) {
+                    if (x_offset) {
+                        gfloat align = gtk_widget_get_direction(widget) == GTK_TEXT_DIR_RTL ? 1.0 - xalign : xalign;
+                        *x_offset = MAX(0, (gint)(align * (cell_area->width - w)));
+                    }
+                    if (y_offset)
+                        *y_offset = MAX(0, (gint)(yalign * (cell_area->height - h)));
+                }
+                else {
+                    if (x_offset) *x_offset = 0;
+                    if (y_offset) *y_offset = 0;
+                }
+                if (width) *width = w;
+                if (height) *height = h;
+            }
+            static void render(GtkCellRenderer *cell, GdkDrawable *window, GtkWidget *widget,
+                               GdkRectangle *, GdkRectangle *cell_area, GdkRectangle *expose_area,
+                               GtkCellRendererState flags) {
+                CustomCellRenderer *r = self(cell);
+                if (!r)
+                    return;
+
+                // the content is placed in the cell by the alignment, a size GetSize() leaves at 0 fills the cell
+                gint xpad, ypad, x_offset, y_offset, width, height;
+                gtk_cell_renderer_get_padding(cell, &xpad, &ypad);
+                get_size(cell, widget, cell_area, &x_offset, &y_offset, &width, &height);
+                if (width <= xpad * 2) {
+                    width = cell_area->width;
+                    x_offset = 0;
+                }
+                if (height <= ypad * 2) {
+                    height = cell_area->height;
+                    y_offset = 0;
+                }
+                width = MIN(width, cell_area->width - x_offset);
+                height = MIN(height, cell_area->height - y_offset);
+                Rect area(cell_area->x + x_offset + xpad, cell_area->y + y_offset + ypad,
+                          width - xpad * 2, height - ypad * 2);
+                if (area.width <= 0 || area.height <= 0)
+                    return;
+
+                cairo::Context cr(window);
+                gdk_cairo_rectangle(cr, expose_area);
+                cr.clip();
+                r->flags_ = flags;
+                r->Render(cr, area);
+            }
+            static void copy_value(GtkTreeViewColumn *, GtkCellRenderer *cell, GtkTreeModel *model,
+                                   GtkTreeIter *it, gpointer column) {
+                if (CustomCellRenderer *r = self(cell)) {
+                    if (G_IS_VALUE(&r->value_))
+                        g_value_unset(&r->value_);
+                    gtk_tree_model_get_value(model, it, GPOINTER_TO_INT(column), &r->value_);
+                }
+            }
+            static void class_init(Class *klass) {
+                GtkCellRendererClass *cell_class = GTK_CELL_RENDERER_CLASS(klass);
+                cell_class->get_size = get_size;
+                cell_class->render = render;
+            }
+            static GType register_type() {
+                static const GTypeInfo info = {
+                    sizeof(Class), NULL, NULL, (GClassInitFunc)class_init, NULL, NULL,
+                    sizeof(Instance), 0, NULL, NULL
+                };
+                return g_type_register_static(GTK_TYPE_CELL_RENDERER, "OOGtkCustomCellRenderer", &info, GTypeFlags(0));
+            }
+        public:
+            static GType Type() {
+                static GType type = register_type();
+                return type;
+            }
+/// DOXYS_ON
+            /// Creates a new renderer, the cells are drawn by the Render() method of the subclass.
+            CustomCellRenderer() : flags_(0) {
+                memset(&value_, 0, sizeof(value_));
+                Init(g_object_new(Type(), NULL));
+                Internal(true);
+                reinterpret_cast<Instance *>(obj_)->self = this;
+            }
+            virtual ~CustomCellRenderer() {
+                // the GObject may survive in a view, from now on it draws nothing
+                if (obj_)
+                    reinterpret_cast<Instance *>(obj_)->self = NULL;
+                if (G_IS_VALUE(&value_))
+                    g_value_unset(&value_);
+            }
+/** Copies a column of the model in the renderer before every cell of column is drawn.
+
+The value is returned by Value(), this replaces any TreeViewColumn::CellData() set on the renderer.
+*/
+            void Bind(TreeViewColumn &column /**< the view column the renderer is packed in */,
+                      int model_column /**< the column of the model */) {
+                gtk_tree_view_column_set_cell_data_func(column, *this, copy_value, GINT_TO_POINTER(model_column), NULL);
+            }
+            /// Returns the value of the bound column for the cell being drawn, see Bind().
+            const GValue &Value() const { return value_; }
+            /// Returns the value of the bound column as a V, converting it when the column has another type, V() if it can't be converted. Use std::string for the string columns.
+            template <typename V>
+            V Value() const {
+                static_assert(!std::is_same<V, const char *>::value, "a converted string is freed before Value() returns, use std::string");
+                if (!G_IS_VALUE(&value_))
+                    return V();
+                if (G_VALUE_TYPE(&value_) == ColumnType<V>::Type())
+                    return ColumnType<V>::Get(&value_);
+
+                GValue typed;
+                memset(&typed, 0, sizeof(typed));
+                g_value_init(&typed, ColumnType<V>::Type());
+                V result = V();
+                if (g_value_transform(&value_, &typed))
+                    result = ColumnType<V>::Get(&typed);
+                else
+                    g_warning("CustomCellRenderer: cannot convert a %s value to %s", G_VALUE_TYPE_NAME(&value_), g_type_name(ColumnType<V>::Type()));
+                g_value_unset(&typed);
+                return result;
+            }
+        protected:
+/** Returns the size of the content of a cell.
+
+width and height are initialized with the fixed size of the renderer (0 when it's not set), the padding is added by the caller. The default keeps them.
+*/
+            virtual void GetSize(GtkWidget *widget /**< the view the renderer draws into */,
+                                 int &width, int &height) {}
+/** Draws a cell.
+
+The context is clipped to the exposed area, area is the content of the cell in the coordinates of the context: the size returned by GetSize() placed in the cell according to the alignment of the renderer, inside the padding. A width or a height GetSize() leaves at 0 takes the whole cell.
+*/
+            virtual void Render(cairo::Context &cr, const Rect &area) = 0;
+
+            /// Returns true if the cell being drawn is in a selected row, to choose contrasting colors in Render().
+            bool Selected() const { return (flags_ & GTK_CELL_RENDERER_SELECTED) != 0; }
+            /// Returns true if the cell being drawn is under the mouse pointer.
+            bool Prelit() const { return (flags_ & GTK_CELL_RENDERER_PRELIT) != 0; }
+    };
+}
+
+#endif
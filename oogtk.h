@@ -2053,7 +2053,7 @@ namespace gtk {
             } else if (GTK_IS_CLIPBOARD(o)) {
                 return new Clipboard(o);
             } else
-                std::cerr << "Undefined type " << g_type_name(GTK_OBJECT_TYPE(o)) << '\n';
+                OOGTK_TRACE(TraceWarning, "Undefined type %s", g_type_name(GTK_OBJECT_TYPE(o)));
         }
 
         return NULL;
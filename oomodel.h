@@ -0,0 +1,1468 @@
+#ifndef OOMODEL_H
+#define OOMODEL_H
+
+/**
+ * GG
+ * TreeModel implementations written in C++, for data sets too big
+ * for ListStore and TreeStore.
+ */
+
+#include "ootree.h"
+#include "ooqueue.h"
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <stdarg.h>
+#include <string.h>
+
+namespace gtk {
+
+/** Base class for the list models implemented in C++.
+
+ListModel registers a GObject type implementing the GtkTreeModel interface for flat lists and forwards the value requests of the views to the derived class. The TreeIter of a ListModel holds the row index, converting between rows, iterators and paths doesn't touch the data, so an attached TreeView only reads the rows it draws.
+
+\sa ColumnarModel, LazyModel, StringList, SortFilterModel
+*/
+    class ListModel : public TreeModel
+    {
+/// DOXYS_OFF
+        protected:
+            // the model data is owned by the GObject, views may keep it alive after the wrapper is gone
+            struct Data {
+                TypeList types;
+                int rows;
+                gint stamp;
+                Data() : rows(0), stamp(g_random_int()) {}
+                virtual ~Data() {}
+                // value is already initialized with the column type and row is valid
+                virtual void get(int row, int col, GValue *value) = 0;
+            };
+        private:
+            struct Instance {
+                GObject parent;
+                Data *data;
+            };
+            struct Class {
+                GObjectClass parent;
+            };
+
+            static gboolean set_iter(Data *d, GtkTreeIter *it, int r) {
+                if (r < 0 || r >= d->rows) {
+                    it->stamp = 0;
+                    return FALSE;
+                }
+                it->stamp = d->stamp;
+                it->user_data = GINT_TO_POINTER(r);
+                it->user_data2 = it->user_data3 = NULL;
+                return TRUE;
+            }
+
+            static GtkTreeModelFlags get_flags(GtkTreeModel *) { return GTK_TREE_MODEL_LIST_ONLY; }
+            static gint get_n_columns(GtkTreeModel *m) { return data(m)->types.size(); }
+            static GType get_column_type(GtkTreeModel *m, gint col) {
+                Data *d = data(m);
+                return col >= 0 && col < (int)d->types.size() ? d->types[col] : G_TYPE_INVALID;
+            }
+            static gboolean get_iter(GtkTreeModel *m, GtkTreeIter *it, GtkTreePath *path) {
+                if (gtk_tree_path_get_depth(path) != 1)
+                    return FALSE;
+                return set_iter(data(m), it, gtk_tree_path_get_indices(path)[0]);
+            }
+            static GtkTreePath *get_path(GtkTreeModel *m, GtkTreeIter *it) {
+                if (!valid(data(m), it))
+                    return NULL;
+                return gtk_tree_path_new_from_indices(row(it), -1);
+            }
+            static void get_value(GtkTreeModel *m, GtkTreeIter *it, gint col, GValue *value) {
+                Data *d = data(m);
+                if (col < 0 || col >= (int)d->types.size())
+                    return;
+
+                g_value_init(value, d->types[col]);
+                if (valid(d, it))
+                    d->get(row(it), col, value);
+            }
+            static gboolean iter_next(GtkTreeModel *m, GtkTreeIter *it) {
+                Data *d = data(m);
+                if (!valid(d, it))
+                    return FALSE;
+                return set_iter(d, it, row(it) + 1);
+            }
+            static gboolean iter_children(GtkTreeModel *m, GtkTreeIter *it, GtkTreeIter *parent) {
+                if (parent)
+                    return FALSE;
+                return set_iter(data(m), it, 0);
+            }
+            static gboolean iter_has_child(GtkTreeModel *, GtkTreeIter *) { return FALSE; }
+            static gint iter_n_children(GtkTreeModel *m, GtkTreeIter *it) { return it ? 0 : data(m)->rows; }
+            static gboolean iter_nth_child(GtkTreeModel *m, GtkTreeIter *it, GtkTreeIter *parent, gint n) {
+                if (parent)
+                    return FALSE;
+                return set_iter(data(m), it, n);
+            }
+            static gboolean iter_parent(GtkTreeModel *, GtkTreeIter *, GtkTreeIter *) { return FALSE; }
+
+            static void finalize(GObject *o) {
+                delete reinterpret_cast<Instance *>(o)->data;
+                // the parent of the list model type, o may be an instance of a subtype
+                G_OBJECT_CLASS(g_type_class_peek_parent(g_type_class_peek(Type())))->finalize(o);
+            }
+            static void class_init(Class *klass) {
+                G_OBJECT_CLASS(klass)->finalize = finalize;
+            }
+            static void iface_init(GtkTreeModelIface *iface) {
+                iface->get_flags = get_flags;
+                iface->get_n_columns = get_n_columns;
+                iface->get_column_type = get_column_type;
+                iface->get_iter = get_iter;
+                iface->get_path = get_path;
+                iface->get_value = get_value;
+                iface->iter_next = iter_next;
+                iface->iter_children = iter_children;
+                iface->iter_has_child = iter_has_child;
+                iface->iter_n_children = iter_n_children;
+                iface->iter_nth_child = iter_nth_child;
+                iface->iter_parent = iter_parent;
+            }
+            static GType register_type() {
+                static const GTypeInfo info = {
+                    sizeof(Class), NULL, NULL, (GClassInitFunc)class_init, NULL, NULL,
+                    sizeof(Instance), 0, NULL, NULL
+                };
+                static const GInterfaceInfo model_info = { (GInterfaceInitFunc)iface_init, NULL, NULL };
+
+                GType type = g_type_register_static(G_TYPE_OBJECT, "OOGtkListModel", &info, GTypeFlags(0));
+                g_type_add_interface_static(type, GTK_TYPE_TREE_MODEL, &model_info);
+                return type;
+            }
+        protected:
+            Data *model_;
+
+            static Data *data(GtkTreeModel *m) { return reinterpret_cast<Instance *>(m)->data; }
+            // registers a subtype of the list model GObject implementing one more interface
+            static GType register_subtype(const char *name, GType iface, GInterfaceInitFunc init) {
+                static const GTypeInfo info = {
+                    sizeof(Class), NULL, NULL, NULL, NULL, NULL, sizeof(Instance), 0, NULL, NULL
+                };
+                GInterfaceInfo iface_info = { init, NULL, NULL };
+
+                GType type = g_type_register_static(Type(), name, &info, GTypeFlags(0));
+                g_type_add_interface_static(type, iface, &iface_info);
+                return type;
+            }
+
+            static int row(const GtkTreeIter *it) { return GPOINTER_TO_INT(it->user_data); }
+            static bool valid(const Data *d, const GtkTreeIter *it) {
+                return it && it->stamp == d->stamp && row(it) >= 0 && row(it) < d->rows;
+            }
+            // the GObject takes the ownership of d
+            void setup(Data *d, GType type = Type()) {
+                Init(g_object_new(type, NULL));
+                Internal(true);
+                model_ = d;
+                reinterpret_cast<Instance *>(obj_)->data = d;
+            }
+            int checked_row(int r) const {
+                if (r < 0 || r >= model_->rows)
+                    throw std::runtime_error("ListModel: invalid row index");
+                return r;
+            }
+            int checked_row(const TreeIter &it) const {
+                if (!valid(model_, &it))
+                    throw std::runtime_error("ListModel: invalid iterator");
+                return row(&it);
+            }
+            bool pending(const char *signal) const {
+                return g_signal_has_handler_pending(obj_, g_signal_lookup(signal, GTK_TYPE_TREE_MODEL), 0, FALSE);
+            }
+            // row-changed is skipped when nobody listens, the other signals are always emitted since
+            // the class closures move the GtkTreeRowReference objects of the model
+            void changed(int r) {
+                if (!pending("row-changed"))
+                    return;
+                TreeIter it;
+                set_iter(model_, &it, r);
+                GtkTreePath *path = gtk_tree_path_new_from_indices(r, -1);
+                gtk_tree_model_row_changed(*this, path, &it);
+                gtk_tree_path_free(path);
+            }
+            // rows [first, first + count) have been added
+            void inserted(int first, int count) {
+                if (count <= 0)
+                    return;
+                GtkTreePath *path = gtk_tree_path_new_from_indices(first, -1);
+                for (int r = first; r < first + count; ++r) {
+                    TreeIter it;
+                    set_iter(model_, &it, r);
+                    gtk_tree_model_row_inserted(*this, path, &it);
+                    gtk_tree_path_next(path);
+                }
+                gtk_tree_path_free(path);
+            }
+            // rows [first, first + count) have been removed, they are deleted from the last one
+            // so the views don't have to renumber the others
+            void deleted(int first, int count) {
+                if (count <= 0)
+                    return;
+                GtkTreePath *path = gtk_tree_path_new_from_indices(first + count, -1);
+                while (count--) {
+                    gtk_tree_path_prev(path);
+                    gtk_tree_model_row_deleted(*this, path);
+                }
+                gtk_tree_path_free(path);
+            }
+            ListModel() : model_(NULL) {}
+/// DOXYS_ON
+        public:
+            /// Returns the GType of the GObject implementing the list models.
+            static GType Type() {
+                static GType type = register_type();
+                return type;
+            }
+            /// Returns the number of rows in the model.
+            int Rows() const { return model_->rows; }
+            /// Returns an iterator pointing to row r.
+            TreeIter RowIter(int r) const {
+                TreeIter it;
+                set_iter(model_, &it, checked_row(r));
+                return it;
+            }
+            /// Returns the row index an iterator points to.
+            int Row(const TreeIter &it) const { return checked_row(it); }
+            bool IsValid(const TreeIter &it) const { return valid(model_, &it); }
+            /// Notifies the views that count rows, starting from first, changed.
+            virtual void RowsChanged(int first, int count = 1) {
+                for (int r = first < 0 ? 0 : first; r < first + count && r < model_->rows; ++r)
+                    changed(r);
+            }
+    };
+
+/** A list TreeModel storing its data by column.
+
+ListStore keeps every row in a separate node holding an array of GValues, so loading millions of rows means millions of allocations. ColumnarModel stores every column in a contiguous vector of native values instead, an int or a boolean column takes 4 bytes per row, a double column 8, a string column 4 (strings are interned in a pool shared by all the string columns of the model, so repeated strings like the symbols in a trading log are stored only once) and an object column (GdkPixbuf for instance) a reference.
+
+Supported column types are G_TYPE_INT, G_TYPE_UINT, G_TYPE_BOOLEAN, G_TYPE_DOUBLE, G_TYPE_FLOAT, G_TYPE_STRING and every G_TYPE_OBJECT derived type.
+
+The fastest way to load a big table is to reserve the rows, fill them with the row based setters, that don't emit any signal, and then attach the model to the view. If the model is already attached to a view call ColumnarModel::RowsChanged() after updating the rows with the row based setters.
+
+\example
+gtk::ColumnarModel model(make_vector(G_TYPE_INT)(G_TYPE_STRING)(G_TYPE_DOUBLE));
+
+int first = model.AppendRows(trades.size());
+for (size_t i = 0; i < trades.size(); ++i) {
+    model.SetValue(first + i, 0, trades[i].id);
+    model.SetValue(first + i, 1, trades[i].symbol);
+    model.SetValue(first + i, 2, trades[i].price);
+}
+view.Model(model);
+\endexample
+
+\note Iterators are invalidated by ColumnarModel::Remove(), ColumnarModel::Insert() and ColumnarModel::Clear(), the model doesn't have the GTK_TREE_MODEL_ITERS_PERSIST flag.
+*/
+    class ColumnarModel : public ListModel
+    {
+/// DOXYS_OFF
+            // interned strings, id 0 is the NULL string
+            class StringPool {
+                    enum { ChunkSize = 64 * 1024 };
+                    std::vector<char *> chunks_;
+                    char *cur_;
+                    size_t left_;
+                    std::vector<const char *> strings_;
+                    std::vector<guint32> hashes_;
+                    std::vector<guint32> table_; // open addressing on ids, 0 is empty
+
+                    static guint32 hash(const char *s, size_t len) {
+                        guint32 h = 2166136261u;
+                        for (size_t i = 0; i < len; ++i)
+                            h = (h ^ (unsigned char)s[i]) * 16777619u;
+                        return h;
+                    }
+                    const char *store(const char *s, size_t len) {
+                        char *p;
+                        if (len + 1 > ChunkSize / 4) {
+                            p = static_cast<char *>(g_malloc(len + 1));
+                            chunks_.push_back(p);
+                        }
+                        else {
+                            if (len + 1 > left_) {
+                                cur_ = static_cast<char *>(g_malloc(ChunkSize));
+                                left_ = ChunkSize;
+                                chunks_.push_back(cur_);
+                            }
+                            p = cur_;
+                            cur_ += len + 1;
+                            left_ -= len + 1;
+                        }
+                        memcpy(p, s, len);
+                        p[len] = 0;
+                        return p;
+                    }
+                    void rehash(size_t size) {
+                        table_.assign(size, 0);
+                        for (guint32 id = 1; id < strings_.size(); ++id) {
+                            size_t pos = hashes_[id] & (size - 1);
+                            while (table_[pos])
+                                pos = (pos + 1) & (size - 1);
+                            table_[pos] = id;
+                        }
+                    }
+                    StringPool(const StringPool &);
+                    StringPool &operator=(const StringPool &);
+                public:
+                    StringPool() : cur_(NULL), left_(0) { Clear(); }
+                    ~StringPool() {
+                        for (size_t i = 0; i < chunks_.size(); ++i)
+                            g_free(chunks_[i]);
+                    }
+                    guint32 Intern(const char *s) {
+                        if (!s)
+                            return 0;
+
+                        size_t len = strlen(s);
+                        guint32 h = hash(s, len);
+                        size_t mask = table_.size() - 1, pos = h & mask;
+
+                        for (guint32 id; (id = table_[pos]) != 0; pos = (pos + 1) & mask)
+                            if (hashes_[id] == h && !memcmp(strings_[id], s, len) && !strings_[id][len])
+                                return id;
+
+                        guint32 id = strings_.size();
+                        strings_.push_back(store(s, len));
+                        hashes_.push_back(h);
+                        table_[pos] = id;
+
+                        if (strings_.size() * 2 > table_.size())
+                            rehash(table_.size() * 2);
+                        return id;
+                    }
+                    const char *Get(guint32 id) const { return strings_[id]; }
+                    void Clear() {
+                        for (size_t i = 0; i < chunks_.size(); ++i)
+                            g_free(chunks_[i]);
+                        chunks_.clear();
+                        cur_ = NULL;
+                        left_ = 0;
+                        strings_.assign(1, (const char *)NULL);
+                        hashes_.assign(1, 0);
+                        table_.assign(64, 0);
+                    }
+            };
+
+            enum Kind { IntKind, DoubleKind, StringKind, ObjectKind };
+
+            struct Column {
+                GType type;
+                Kind kind;
+                std::vector<gint> ints;
+                std::vector<gdouble> doubles;
+                std::vector<guint32> strings;
+                std::vector<GObject *> objects;
+
+                void resize(size_t rows) {
+                    switch (kind) {
+                        case IntKind: ints.resize(rows); break;
+                        case DoubleKind: doubles.resize(rows); break;
+                        case StringKind: strings.resize(rows); break;
+                        case ObjectKind: objects.resize(rows, (GObject *)NULL); break;
+                    }
+                }
+                void reserve(size_t rows) {
+                    switch (kind) {
+                        case IntKind: ints.reserve(rows); break;
+                        case DoubleKind: doubles.reserve(rows); break;
+                        case StringKind: strings.reserve(rows); break;
+                        case ObjectKind: objects.reserve(rows); break;
+                    }
+                }
+                void insert(size_t row) {
+                    switch (kind) {
+                        case IntKind: ints.insert(ints.begin() + row, 0); break;
+                        case DoubleKind: doubles.insert(doubles.begin() + row, 0.0); break;
+                        case StringKind: strings.insert(strings.begin() + row, 0); break;
+                        case ObjectKind: objects.insert(objects.begin() + row, (GObject *)NULL); break;
+                    }
+                }
+                void erase(size_t row) {
+                    switch (kind) {
+                        case IntKind: ints.erase(ints.begin() + row); break;
+                        case DoubleKind: doubles.erase(doubles.begin() + row); break;
+                        case StringKind: strings.erase(strings.begin() + row); break;
+                        case ObjectKind:
+                            if (objects[row])
+                                g_object_unref(objects[row]);
+                            objects.erase(objects.begin() + row);
+                            break;
+                    }
+                }
+                void clear() {
+                    for (size_t i = 0; i < objects.size(); ++i)
+                        if (objects[i])
+                            g_object_unref(objects[i]);
+                    std::vector<gint>().swap(ints);
+                    std::vector<gdouble>().swap(doubles);
+                    std::vector<guint32>().swap(strings);
+                    std::vector<GObject *>().swap(objects);
+                }
+            };
+
+            struct Data : public ListModel::Data {
+                std::vector<Column> columns;
+                StringPool pool;
+                ~Data() {
+                    for (size_t i = 0; i < columns.size(); ++i)
+                        columns[i].clear();
+                }
+                void get(int r, int col, GValue *value) {
+                    const Column &c = columns[col];
+                    switch (c.kind) {
+                        case IntKind:
+                            if (c.type == G_TYPE_BOOLEAN)
+                                g_value_set_boolean(value, c.ints[r]);
+                            else if (c.type == G_TYPE_UINT)
+                                g_value_set_uint(value, c.ints[r]);
+                            else
+                                g_value_set_int(value, c.ints[r]);
+                            break;
+                        case DoubleKind:
+                            if (c.type == G_TYPE_FLOAT)
+                                g_value_set_float(value, c.doubles[r]);
+                            else
+                                g_value_set_double(value, c.doubles[r]);
+                            break;
+                        case StringKind:
+                            // the pool lives as long as the model, no copy needed
+                            g_value_set_static_string(value, pool.Get(c.strings[r]));
+                            break;
+                        case ObjectKind:
+                            g_value_set_object(value, c.objects[r]);
+                            break;
+                    }
+                }
+            };
+
+            Data *data_;
+
+            Column &column(int col) const {
+                if (col < 0 || col >= (int)data_->columns.size())
+                    throw std::runtime_error("ColumnarModel: invalid column index");
+                return data_->columns[col];
+            }
+            Column &column(int col, Kind kind) const {
+                Column &c = column(col);
+                if (c.kind != kind)
+                    throw std::runtime_error(std::string("ColumnarModel: wrong value for a column of type ") + g_type_name(c.type));
+                return c;
+            }
+            void setup(const TypeList &types) {
+                Data *d = new Data();
+                d->types = types;
+
+                for (size_t i = 0; i < types.size(); ++i) {
+                    Column c;
+                    c.type = types[i];
+                    if (c.type == G_TYPE_INT || c.type == G_TYPE_UINT || c.type == G_TYPE_BOOLEAN)
+                        c.kind = IntKind;
+                    else if (c.type == G_TYPE_DOUBLE || c.type == G_TYPE_FLOAT)
+                        c.kind = DoubleKind;
+                    else if (c.type == G_TYPE_STRING)
+                        c.kind = StringKind;
+                    else if (g_type_is_a(c.type, G_TYPE_OBJECT))
+                        c.kind = ObjectKind;
+                    else {
+                        delete d;
+                        throw std::runtime_error(std::string("ColumnarModel: unsupported column type ") + g_type_name(c.type));
+                    }
+                    d->columns.push_back(c);
+                }
+                ListModel::setup(d);
+                data_ = d;
+            }
+            void set_object(Column &c, int r, void *value) {
+                GObject *o = value ? G_OBJECT(value) : NULL;
+                if (o)
+                    g_object_ref(o);
+                if (c.objects[r])
+                    g_object_unref(c.objects[r]);
+                c.objects[r] = o;
+            }
+/// DOXYS_ON
+        public:
+            ColumnarModel(const TypeList &types) { setup(types); }
+            ColumnarModel(size_t size, ...) {
+                va_list va;
+                TypeList types;
+                va_start(va, size);
+                while (size--)
+                    types.push_back(va_arg(va, GType));
+                va_end(va);
+                setup(types);
+            }
+
+            /// Preallocates the storage for rows rows, to avoid reallocations while loading a known amount of data.
+            void Reserve(int rows) {
+                for (size_t i = 0; i < data_->columns.size(); ++i)
+                    data_->columns[i].reserve(rows);
+            }
+            /** Appends count rows with empty values (0, NULL strings and objects) to the model.
+            \return the index of the first appended row.
+            */
+            int AppendRows(int count) {
+                int first = data_->rows;
+                if (count <= 0)
+                    return first;
+                for (size_t i = 0; i < data_->columns.size(); ++i)
+                    data_->columns[i].resize(first + count);
+                data_->rows += count;
+                inserted(first, count);
+                return first;
+            }
+            /// Appends an empty row to the model.
+            TreeIter Append() { return RowIter(AppendRows(1)); }
+            /// Inserts an empty row at position, this moves all the following rows so it's a slow operation on big models.
+            TreeIter Insert(int position) {
+                if (position < 0 || position >= data_->rows)
+                    return Append();
+                for (size_t i = 0; i < data_->columns.size(); ++i)
+                    data_->columns[i].insert(position);
+                data_->rows++;
+                data_->stamp++;
+                inserted(position, 1);
+                return RowIter(position);
+            }
+            /// Removes a row, this moves all the following rows so it's a slow operation on big models.
+            void Remove(int r) {
+                checked_row(r);
+                for (size_t i = 0; i < data_->columns.size(); ++i)
+                    data_->columns[i].erase(r);
+                data_->rows--;
+                data_->stamp++;
+                deleted(r, 1);
+            }
+            void Remove(const TreeIter &it) { Remove(checked_row(it)); }
+            /// Removes all the rows and releases the storage of the model, including the string pool.
+            void Clear() {
+                int rows = data_->rows;
+                for (size_t i = 0; i < data_->columns.size(); ++i)
+                    data_->columns[i].clear();
+                data_->pool.Clear();
+                data_->rows = 0;
+                data_->stamp++;
+                deleted(0, rows);
+            }
+
+            /** \name Row based access
+            These setters don't emit any signal, call ColumnarModel::RowsChanged() when the model is attached to a view.
+            */
+            void SetValue(int r, int col, int value) {
+                Column &c = column(col);
+                if (c.kind == DoubleKind)
+                    c.doubles[checked_row(r)] = value;
+                else
+                    column(col, IntKind).ints[checked_row(r)] = value;
+            }
+            void SetValue(int r, int col, bool value) { column(col, IntKind).ints[checked_row(r)] = value; }
+            void SetValue(int r, int col, double value) { column(col, DoubleKind).doubles[checked_row(r)] = value; }
+            void SetValue(int r, int col, const char *value) {
+                column(col, StringKind).strings[checked_row(r)] = data_->pool.Intern(value);
+            }
+            void SetValue(int r, int col, const std::string &value) { SetValue(r, col, value.c_str()); }
+            /// Sets an object column, the model keeps a reference to the object.
+            void SetValue(int r, int col, void *value) { set_object(column(col, ObjectKind), checked_row(r), value); }
+
+            int IntValue(int r, int col) const { return column(col, IntKind).ints[checked_row(r)]; }
+            double DoubleValue(int r, int col) const { return column(col, DoubleKind).doubles[checked_row(r)]; }
+            /// Returns the string stored in a row, the pointer is valid until the model is cleared or destroyed.
+            const char *StringValue(int r, int col) const {
+                return data_->pool.Get(column(col, StringKind).strings[checked_row(r)]);
+            }
+            /// Returns the object stored in a row, without adding a reference.
+            GObject *ObjectValue(int r, int col) const { return column(col, ObjectKind).objects[checked_row(r)]; }
+
+            /** \name TreeModel interface
+            These setters emit the row-changed signal.
+            */
+            void SetValue(const TreeIter &it, int idx, int value) { SetValue(checked_row(it), idx, value); changed(row(&it)); }
+            void SetValue(const TreeIter &it, int idx, bool value) { SetValue(checked_row(it), idx, value); changed(row(&it)); }
+            void SetValue(const TreeIter &it, int idx, double value) { SetValue(checked_row(it), idx, value); changed(row(&it)); }
+            void SetValue(const TreeIter &it, int idx, const std::string &value) { SetValue(checked_row(it), idx, value); changed(row(&it)); }
+            void SetValue(const TreeIter &it, int idx, void *value) { SetValue(checked_row(it), idx, value); changed(row(&it)); }
+
+            /** Sets one or more columns of a row, the parameters are pairs of column number and value, terminated by -1, like ListStore::Set().
+            Values must have the C type of the column: int (also for booleans), double (also for floats), const char * or a GObject pointer.
+            */
+            void Set(TreeIter it, ...) {
+                int r = checked_row(it);
+                va_list va;
+                va_start(va, it);
+                for (int col; (col = va_arg(va, int)) != -1; ) {
+                    Column &c = column(col);
+                    switch (c.kind) {
+                        case IntKind: c.ints[r] = va_arg(va, int); break;
+                        case DoubleKind: c.doubles[r] = va_arg(va, double); break;
+                        case StringKind: c.strings[r] = data_->pool.Intern(va_arg(va, const char *)); break;
+                        case ObjectKind: set_object(c, r, va_arg(va, void *)); break;
+                    }
+                }
+                va_end(va);
+                changed(r);
+            }
+    };
+
+/** A read only list TreeModel that fetches its values on demand.
+
+The values of a LazyModel are not stored in the model, they are requested to a provider method when a view needs them, so only the rows the TreeView draws are ever fetched. The provider receives the row, the column and a GValue already initialized with the column type, that it must set.
+
+Fetched values are kept in a least recently used cache of LazyModel::CacheSize() cells, call LazyModel::RowsChanged() when the underlying data changes, it drops the cached values of the rows and notifies the views, and LazyModel::Rows(int) when the number of rows changes.
+
+\example
+class ResultView {
+    gtk::LazyModel model_;
+    Query &query_;
+public:
+    ResultView(Query &q) : model_(make_vector(G_TYPE_INT)(G_TYPE_STRING), q.Count()), query_(q) {
+        model_.Provider(&ResultView::fetch, this);
+    }
+    void fetch(int row, int col, GValue *value) {
+        if (col == 0)
+            g_value_set_int(value, query_.Id(row));
+        else
+            g_value_set_string(value, query_.Name(row).c_str());
+    }
+};
+\endexample
+
+\note The provider is called in the main loop, while the view is drawing, so it should be fast: a provider reading from a database should fetch the data in blocks of rows and keep them until the next request.
+*/
+    class LazyModel : public ListModel
+    {
+/// DOXYS_OFF
+            struct AbstractProvider {
+                virtual ~AbstractProvider() {}
+                virtual void fetch(int row, int col, GValue *value) const = 0;
+            };
+            template <typename T>
+            struct ProviderCbk : public AbstractProvider {
+                T *myObj;
+                void (T::*myFnc)(int, int, GValue *);
+                ProviderCbk(T *obj, void (T::*fnc)(int, int, GValue *)) : myObj(obj), myFnc(fnc) {}
+                void fetch(int row, int col, GValue *value) const { (myObj->*myFnc)(row, col, value); }
+            };
+
+            struct Entry {
+                gint64 key;
+                GValue value;
+            };
+            typedef std::list<Entry> Cache;
+
+            struct Data : public ListModel::Data {
+                AbstractProvider *provider;
+                size_t capacity;
+                Cache cache; // most recently used first
+                std::map<gint64, Cache::iterator> index;
+
+                Data() : provider(NULL), capacity(0) {}
+                ~Data() {
+                    Drop(0, rows);
+                    delete provider;
+                }
+                gint64 key(int row, int col) const { return (gint64)row * types.size() + col; }
+                void get(int row, int col, GValue *value) {
+                    gint64 k = key(row, col);
+                    std::map<gint64, Cache::iterator>::iterator it = index.find(k);
+
+                    if (it != index.end()) {
+                        cache.splice(cache.begin(), cache, it->second);
+                        g_value_copy(&it->second->value, value);
+                        return;
+                    }
+                    if (!provider)
+                        return;
+
+                    provider->fetch(row, col, value);
+                    if (!capacity)
+                        return;
+
+                    Entry e;
+                    e.key = k;
+                    memset(&e.value, 0, sizeof(e.value));
+                    g_value_init(&e.value, G_VALUE_TYPE(value));
+                    g_value_copy(value, &e.value);
+                    cache.push_front(e);
+                    index[k] = cache.begin();
+                    Trim();
+                }
+                void Trim() {
+                    while (index.size() > capacity) {
+                        index.erase(cache.back().key);
+                        g_value_unset(&cache.back().value);
+                        cache.pop_back();
+                    }
+                }
+                // drops the cached values of the rows [first, first + count)
+                void Drop(int first, int count) {
+                    std::map<gint64, Cache::iterator>::iterator b = index.lower_bound(key(first, 0));
+                    std::map<gint64, Cache::iterator>::iterator e = index.lower_bound(key(first + count, 0));
+
+                    for (std::map<gint64, Cache::iterator>::iterator it = b; it != e; ++it) {
+                        g_value_unset(&it->second->value);
+                        cache.erase(it->second);
+                    }
+                    index.erase(b, e);
+                }
+            };
+
+            Data *data_;
+
+            void unsupported() const { throw std::runtime_error("LazyModel is read only"); }
+/// DOXYS_ON
+        public:
+            /// Creates a model with the given column types and number of rows, with a cache of cache_size values.
+            LazyModel(const TypeList &types, int rows = 0, size_t cache_size = 4096) {
+                data_ = new Data();
+                data_->types = types;
+                data_->rows = rows > 0 ? rows : 0;
+                data_->capacity = cache_size;
+                setup(data_);
+            }
+            /// Detaches the provider, a view still using the model will show empty cells.
+            ~LazyModel() {
+                delete data_->provider;
+                data_->provider = NULL;
+                data_->Drop(0, data_->rows);
+            }
+
+            /// Sets the method that provides the values of the cells, drops the cached values and notifies the views that all the rows changed, so it's better to call it before attaching the model to a view.
+            template <typename T>
+            void Provider(void (T::*fetch)(int, int, GValue *) /**< the provider method */,
+                          T *base /**< the object the method belongs to */) {
+                delete data_->provider;
+                data_->provider = new ProviderCbk<T>(base, fetch);
+                RowsChanged(0, data_->rows);
+            }
+            /// Sets the maximum number of cached values, 0 disables the cache.
+            void CacheSize(size_t cells) {
+                data_->capacity = cells;
+                data_->Trim();
+            }
+            /// Returns the maximum number of cached values.
+            size_t CacheSize() const { return data_->capacity; }
+            /// Returns the number of cached values.
+            size_t Cached() const { return data_->index.size(); }
+
+            using ListModel::Rows;
+            /** Changes the number of rows of the model.
+            Rows are added or removed at the end of the model, the views are notified of the change.
+            */
+            void Rows(int rows) {
+                if (rows < 0)
+                    rows = 0;
+
+                int old = data_->rows;
+                if (rows > old) {
+                    data_->rows = rows;
+                    inserted(old, rows - old);
+                }
+                else if (rows < old) {
+                    data_->Drop(rows, old - rows);
+                    data_->rows = rows;
+                    data_->stamp++;
+                    deleted(rows, old - rows);
+                }
+            }
+            /// Drops the cached values of count rows, starting from first, and notifies the views that they changed.
+            void RowsChanged(int first, int count = 1) {
+                if (count <= 0)
+                    return;
+                data_->Drop(first, count);
+                ListModel::RowsChanged(first, count);
+            }
+
+            /// \name TreeModel interface
+            /// A LazyModel is read only, these methods throw std::runtime_error.
+            void Remove(const TreeIter &) { unsupported(); }
+            void Set(TreeIter, ...) { unsupported(); }
+            void SetValue(const TreeIter &, int, int) { unsupported(); }
+            void SetValue(const TreeIter &, int, const std::string &) { unsupported(); }
+            void SetValue(const TreeIter &, int, void *) { unsupported(); }
+            void SetValue(const TreeIter &, int, bool) { unsupported(); }
+    };
+
+/** An immutable list of strings, shared by many views.
+
+StringList is a list model with a single G_TYPE_STRING column whose strings are copied once in a contiguous buffer when the model is created, the views get pointers to them without any copy. Since the list can't change, the same StringList can be the model of hundreds of ComboBox widgets (or EntryCompletion objects) showing the same choices, the strings are stored once and no widget has to fill its own ListStore.
+
+The strings are owned by the model GObject, the StringList wrapper can be destroyed while the combos still use the model.
+
+\example
+gtk::StringList countries(names);
+for (size_t i = 0; i < forms.size(); ++i) {
+    forms[i].country.Model(countries);
+    forms[i].country.Active(countries.Find(forms[i].value));
+}
+\endexample
+
+\note A ComboBoxText using a StringList must not be changed with ComboBoxText::Append(), ComboBoxText::Remove() and the like, they expect a ListStore. ComboBoxText::Assign() gives a combo a private list again.
+*/
+    class StringList : public ListModel
+    {
+/// DOXYS_OFF
+            struct Data : public ListModel::Data {
+                std::vector<char> chars;
+                std::vector<size_t> offsets;
+                const char *string(int row) const { return &chars[offsets[row]]; }
+                void get(int row, int, GValue *value) { g_value_set_static_string(value, string(row)); }
+            };
+
+            Data *data_;
+
+            void unsupported() const { throw std::runtime_error("StringList is read only"); }
+/// DOXYS_ON
+        public:
+            /// Creates a model holding a copy of the strings.
+            StringList(const std::vector<std::string> &strings) {
+                data_ = new Data();
+                data_->types.push_back(G_TYPE_STRING);
+
+                size_t size = 0;
+                for (size_t i = 0; i < strings.size(); ++i)
+                    size += strings[i].size() + 1;
+                data_->chars.reserve(size);
+                data_->offsets.reserve(strings.size());
+                for (size_t i = 0; i < strings.size(); ++i) {
+                    data_->offsets.push_back(data_->chars.size());
+                    data_->chars.insert(data_->chars.end(), strings[i].c_str(), strings[i].c_str() + strings[i].size() + 1);
+                }
+                data_->rows = strings.size();
+                setup(data_);
+            }
+            /// Returns the string of a row.
+            const char *String(int row) const { return data_->string(checked_row(row)); }
+            /// Returns the first row holding text, -1 if there isn't any.
+            int Find(const std::string &text) const {
+                for (int r = 0; r < data_->rows; ++r)
+                    if (text == data_->string(r))
+                        return r;
+                return -1;
+            }
+
+            /// \name TreeModel interface
+            /// A StringList is read only, these methods throw std::runtime_error.
+            void Remove(const TreeIter &) { unsupported(); }
+            void Set(TreeIter, ...) { unsupported(); }
+            void SetValue(const TreeIter &, int, int) { unsupported(); }
+            void SetValue(const TreeIter &, int, const std::string &) { unsupported(); }
+            void SetValue(const TreeIter &, int, void *) { unsupported(); }
+            void SetValue(const TreeIter &, int, bool) { unsupported(); }
+    };
+
+/** A sorted and filtered view of a list model, computed in parallel.
+
+SortFilterModel shows the rows of a child list model (a ListStore, a ColumnarModel...) sorted on a column and filtered by a case insensitive text search on a column. Sorting through GtkTreeModelSort compares the GValues of the rows one pair at a time in the main loop, on a million rows of strings it blocks the interface for seconds; SortFilterModel instead reads the keys of the sort and filter columns once in a contiguous snapshot, prepares them (collation keys for the sort, case folded strings for the filter), filters and sorts them on a WorkerPool and, back in the main loop, swaps in the new order with a single rows-reordered signal. Only the rows that appear or disappear because of the filter get a row-inserted or row-deleted signal.
+
+The snapshot is kept until the child changes, so changing the filter at every keystroke only runs the parallel filter and sort; a new request while a computation is running is queued and only the latest one is computed. The model implements GtkTreeSortable, so the columns of a TreeView with a sort column id sort the rows in parallel too.
+
+\example
+gtk::SortFilterModel proxy(store);
+tv.Model(proxy);
+tv.AddSortableTextColumn("Message", 1); // clicking the header sorts in parallel
+...
+void MyApp::search_changed() {
+    proxy.Filter(1, search.Get());
+}
+\endexample
+
+The rows of the child are referenced by index: while a sort or a filter is active every row inserted or deleted in the child renumbers the rows that follow it (the proxy keeps an index from the child rows to its own rows, so appending or changing a row takes a constant time), load big data sets in the child before attaching the proxy or with the proxy in its unsorted and unfiltered state, when it's just a thin layer over the child.
+
+\note The values are read from the child in the main loop, the worker threads only see the snapshot. The WorkerPool must outlive the model, by default a pool shared by every SortFilterModel is used.
+*/
+    class SortFilterModel : public ListModel
+    {
+/// DOXYS_OFF
+            // the values of a column of every child row
+            struct Keys {
+                int column;
+                bool strings;
+                bool ready; // the strings are already collation keys or folded strings
+                std::vector<double> numbers;
+                std::string text; // NUL terminated strings
+                std::vector<size_t> offsets;
+
+                Keys(int col) : column(col), strings(false), ready(false) {}
+                const char *String(int r) const { return text.c_str() + offsets[r]; }
+            };
+            typedef std::shared_ptr<Keys> KeysPtr;
+
+            struct Less {
+                const Keys *keys;
+                bool descending;
+                Less(const Keys *k, bool d) : keys(k), descending(d) {}
+                bool operator()(int a, int b) const {
+                    int c;
+                    if (keys->strings)
+                        c = strcmp(keys->String(a), keys->String(b));
+                    else
+                        c = keys->numbers[a] < keys->numbers[b] ? -1 : keys->numbers[a] > keys->numbers[b];
+                    if (c == 0)
+                        return a < b;
+                    return descending ? c > 0 : c < 0;
+                }
+            };
+
+            struct Data;
+
+            // a sort and filter computation, runs in the pool and hands the result to the main loop
+            struct Job {
+                Data *data;
+                GObject *self;
+                unsigned generation;
+                int rows, blocks;
+                KeysPtr sort, filter;
+                bool descending;
+                std::string needle;
+                gchar *(*transform)(const gchar *, gssize);
+                Keys *transformed;
+                std::vector<std::string> texts;
+                std::vector<std::vector<size_t> > offsets;
+                std::vector<std::vector<int> > parts;
+                std::vector<int> result, merged;
+                std::vector<size_t> runs; // boundaries of the sorted runs of result
+
+                size_t begin(int block, size_t n) const { return (size_t)block * n / blocks; }
+
+                // builds the collation keys or the folded strings of a block of rows
+                void transform_block(int b) {
+                    Keys *k = transformed;
+                    std::string &out = texts[b];
+                    std::vector<size_t> &offs = offsets[b];
+                    for (size_t r = begin(b, rows); r < begin(b + 1, rows); ++r) {
+                        gchar *s = transform(k->String(r), -1);
+                        offs.push_back(out.size());
+                        out += s;
+                        out += '\0';
+                        g_free(s);
+                    }
+                }
+                void prepare(Keys *k, gchar *(*fnc)(const gchar *, gssize)) {
+                    if (!k || !k->strings || k->ready)
+                        return;
+                    transformed = k;
+                    transform = fnc;
+                    texts.assign(blocks, std::string());
+                    offsets.assign(blocks, std::vector<size_t>());
+                    data->pool->ForEach(blocks, &Job::transform_block, this);
+
+                    k->text.clear();
+                    k->offsets.clear();
+                    for (int b = 0; b < blocks; ++b) {
+                        size_t base = k->text.size();
+                        for (size_t i = 0; i < offsets[b].size(); ++i)
+                            k->offsets.push_back(base + offsets[b][i]);
+                        k->text += texts[b];
+                    }
+                    k->offsets.push_back(k->text.size());
+                    k->ready = true;
+                    texts.clear();
+                    offsets.clear();
+                }
+                void filter_block(int b) {
+                    std::vector<int> &out = parts[b];
+                    for (size_t r = begin(b, rows); r < begin(b + 1, rows); ++r)
+                        if (!filter || strstr(filter->String(r), needle.c_str()))
+                            out.push_back(r);
+                }
+                void sort_block(int b) {
+                    std::sort(result.begin() + runs[b], result.begin() + runs[b + 1], Less(sort.get(), descending));
+                }
+                // merges the runs 2 * i and 2 * i + 1 in merged, the last run may be alone
+                void merge_pair(int i) {
+                    size_t last = runs.size() - 1;
+                    size_t first = runs[2 * i];
+                    size_t middle = runs[std::min(last, (size_t)2 * i + 1)];
+                    size_t end = runs[std::min(last, (size_t)2 * i + 2)];
+                    std::merge(result.begin() + first, result.begin() + middle,
+                               result.begin() + middle, result.begin() + end,
+                               merged.begin() + first, Less(sort.get(), descending));
+                }
+                void run() {
+                    prepare(filter.get(), g_utf8_casefold);
+                    prepare(sort.get(), g_utf8_collate_key);
+
+                    parts.assign(blocks, std::vector<int>());
+                    data->pool->ForEach(blocks, &Job::filter_block, this);
+                    for (int b = 0; b < blocks; ++b)
+                        result.insert(result.end(), parts[b].begin(), parts[b].end());
+                    parts.clear();
+
+                    if (sort) {
+                        // sorts a run per block in parallel, then merges the runs in pairs, in parallel too
+                        size_t n = result.size();
+                        for (int b = 0; b <= blocks; ++b)
+                            runs.push_back(begin(b, n));
+                        data->pool->ForEach(blocks, &Job::sort_block, this);
+
+                        merged.resize(n);
+                        while (runs.size() > 2) {
+                            int pairs = runs.size() / 2;
+                            data->pool->ForEach(pairs, &Job::merge_pair, this);
+                            result.swap(merged);
+
+                            std::vector<size_t> next;
+                            for (size_t i = 0; i < runs.size() - 1; i += 2)
+                                next.push_back(runs[i]);
+                            next.push_back(n);
+                            runs.swap(next);
+                        }
+                    }
+                    g_idle_add_full(G_PRIORITY_HIGH_IDLE, GSourceFunc(done), this, NULL);
+                }
+                static gboolean done(gpointer p) {
+                    Job *job = static_cast<Job *>(p);
+                    GObject *self = job->self;
+                    job->data->finished(job);
+                    delete job;
+                    g_object_unref(self);
+                    return FALSE;
+                }
+            };
+
+            struct Data : public ListModel::Data {
+                GtkTreeModel *self;
+                GtkTreeModel *child;
+                WorkerPool *pool;
+                gulong handlers[4];
+                // no sort and no filter, the proxy row is the child row and map is empty
+                bool identity;
+                // proxy row -> child row, and where: child row -> proxy row or -1 if filtered out
+                std::vector<int> map, where;
+                int sort_column, filter_column;
+                bool descending;
+                std::string needle;
+                KeysPtr sort_keys, filter_keys;
+                // incremented when the child rows are renumbered, the results computed before are dropped
+                unsigned generation;
+                Job *job;
+                bool again;
+                guint idle;
+
+                Data(GtkTreeModel *c, WorkerPool *p) : self(NULL), child(c), pool(p), identity(true),
+                    sort_column(-1), filter_column(-1), descending(false), generation(0), job(NULL), again(false), idle(0) {
+                    g_object_ref(child);
+                    for (int i = 0; i < gtk_tree_model_get_n_columns(child); ++i)
+                        types.push_back(gtk_tree_model_get_column_type(child, i));
+                    rows = gtk_tree_model_iter_n_children(child, NULL);
+
+                    handlers[0] = g_signal_connect(child, "row-inserted", GCallback(row_inserted), this);
+                    handlers[1] = g_signal_connect(child, "row-deleted", GCallback(row_deleted), this);
+                    handlers[2] = g_signal_connect(child, "row-changed", GCallback(row_changed), this);
+                    handlers[3] = g_signal_connect(child, "rows-reordered", GCallback(rows_reordered), this);
+                }
+                ~Data() {
+                    for (int i = 0; i < 4; ++i)
+                        g_signal_handler_disconnect(child, handlers[i]);
+                    if (idle)
+                        g_source_remove(idle);
+                    g_object_unref(child);
+                }
+
+                int child_row(int r) const { return identity ? r : map[r]; }
+                void get(int row, int col, GValue *value) {
+                    GtkTreeIter it;
+                    if (gtk_tree_model_iter_nth_child(child, &it, NULL, child_row(row))) {
+                        g_value_unset(value);
+                        gtk_tree_model_get_value(child, &it, col, value);
+                    }
+                }
+                bool active() const { return sort_column >= 0 || !needle.empty(); }
+                int position(int child_row) const {
+                    if (identity)
+                        return child_row;
+                    return child_row < (int)where.size() ? where[child_row] : -1;
+                }
+                // rebuilds where after map changed as a whole
+                void reindex() {
+                    where.assign(gtk_tree_model_iter_n_children(child, NULL), -1);
+                    for (size_t p = 0; p < map.size(); ++p)
+                        where[map[p]] = p;
+                }
+
+                // signals of the proxy, only row-changed is skipped when nobody listens (see ListModel::changed())
+                bool pending(const char *signal) const {
+                    return g_signal_has_handler_pending(self, g_signal_lookup(signal, GTK_TYPE_TREE_MODEL), 0, FALSE);
+                }
+                void emit_inserted(int r) {
+                    GtkTreeIter it;
+                    set_iter(this, &it, r);
+                    GtkTreePath *path = gtk_tree_path_new_from_indices(r, -1);
+                    gtk_tree_model_row_inserted(self, path, &it);
+                    gtk_tree_path_free(path);
+                }
+                void emit_changed(int r) {
+                    if (!pending("row-changed"))
+                        return;
+                    GtkTreeIter it;
+                    set_iter(this, &it, r);
+                    GtkTreePath *path = gtk_tree_path_new_from_indices(r, -1);
+                    gtk_tree_model_row_changed(self, path, &it);
+                    gtk_tree_path_free(path);
+                }
+                void emit_deleted(int r) {
+                    GtkTreePath *path = gtk_tree_path_new_from_indices(r, -1);
+                    gtk_tree_model_row_deleted(self, path);
+                    gtk_tree_path_free(path);
+                }
+                void emit_reordered(std::vector<int> &new_order) {
+                    if (new_order.empty())
+                        return;
+                    GtkTreePath *path = gtk_tree_path_new();
+                    gtk_tree_model_rows_reordered(self, path, NULL, &new_order[0]);
+                    gtk_tree_path_free(path);
+                }
+                static gboolean set_iter(Data *d, GtkTreeIter *it, int r) {
+                    it->stamp = d->stamp;
+                    it->user_data = GINT_TO_POINTER(r);
+                    it->user_data2 = it->user_data3 = NULL;
+                    return TRUE;
+                }
+
+                // the values of the child changed, the snapshot must be read again
+                void invalidate() {
+                    sort_keys.reset();
+                    filter_keys.reset();
+                }
+                void schedule() {
+                    if (!idle)
+                        idle = g_idle_add(GSourceFunc(idle_refresh), this);
+                }
+                static gboolean idle_refresh(gpointer p) {
+                    Data *d = static_cast<Data *>(p);
+                    d->idle = 0;
+                    d->refresh();
+                    return FALSE;
+                }
+
+                static int index(GtkTreePath *path) { return gtk_tree_path_get_indices(path)[0]; }
+                static void row_inserted(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, Data *d) {
+                    int k = index(path);
+                    d->invalidate();
+                    // an append doesn't renumber the other rows, a running computation is still valid
+                    if (k < gtk_tree_model_iter_n_children(d->child, NULL) - 1)
+                        ++d->generation;
+                    if (d->identity) {
+                        d->rows++;
+                        d->stamp++;
+                        d->emit_inserted(k);
+                        // the first sort or filter may be running without the new row
+                        if (d->job || d->active())
+                            d->schedule();
+                        return;
+                    }
+                    // shown by the next refresh, an append doesn't renumber anything
+                    d->where.insert(d->where.begin() + k, -1);
+                    for (size_t r = k + 1; r < d->where.size(); ++r)
+                        if (d->where[r] >= 0)
+                            d->map[d->where[r]]++;
+                    d->schedule();
+                }
+                static void row_deleted(GtkTreeModel *, GtkTreePath *path, Data *d) {
+                    int k = index(path), pos = -1;
+                    d->invalidate();
+                    ++d->generation;
+                    if (d->identity)
+                        pos = k;
+                    else {
+                        // only the child rows after k and the proxy rows after pos are renumbered
+                        pos = d->where[k];
+                        d->where.erase(d->where.begin() + k);
+                        for (size_t r = k; r < d->where.size(); ++r)
+                            if (d->where[r] >= 0)
+                                d->map[d->where[r]]--;
+                        if (pos >= 0) {
+                            d->map.erase(d->map.begin() + pos);
+                            for (size_t p = pos; p < d->map.size(); ++p)
+                                d->where[d->map[p]] = p;
+                        }
+                    }
+                    if (pos >= 0) {
+                        d->rows--;
+                        d->stamp++;
+                        d->emit_deleted(pos);
+                    }
+                }
+                static void row_changed(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, Data *d) {
+                    int pos = d->position(index(path));
+                    if (pos >= 0)
+                        d->emit_changed(pos);
+                    // the snapshot is kept for the next Filter() even while nothing is active
+                    d->invalidate();
+                    if (d->active())
+                        d->schedule();
+                }
+                static void rows_reordered(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, gint *new_order, Data *d) {
+                    if (gtk_tree_path_get_depth(path) != 0)
+                        return;
+                    int n = gtk_tree_model_iter_n_children(d->child, NULL);
+                    d->invalidate();
+                    ++d->generation;
+                    if (d->identity) {
+                        std::vector<int> order(new_order, new_order + n);
+                        d->emit_reordered(order);
+                        return;
+                    }
+                    std::vector<int> moved(n);
+                    for (int i = 0; i < n; ++i)
+                        moved[new_order[i]] = i;
+                    for (size_t p = 0; p < d->map.size(); ++p)
+                        d->map[p] = moved[d->map[p]];
+                    d->reindex();
+                    d->schedule();
+                }
+
+                // reads the keys of a column of every child row
+                KeysPtr snapshot(int col) {
+                    KeysPtr k(new Keys(col));
+                    GType type = gtk_tree_model_get_column_type(child, col);
+                    k->strings = g_type_is_a(type, G_TYPE_STRING) || !g_value_type_transformable(type, G_TYPE_DOUBLE);
+
+                    GtkTreeIter it;
+                    GValue value, conv;
+                    memset(&value, 0, sizeof(value));
+                    memset(&conv, 0, sizeof(conv));
+                    g_value_init(&conv, k->strings ? G_TYPE_STRING : G_TYPE_DOUBLE);
+
+                    if (k->strings)
+                        k->offsets.reserve(rows + 1);
+                    else
+                        k->numbers.reserve(rows);
+                    for (bool ok = gtk_tree_model_get_iter_first(child, &it); ok; ok = gtk_tree_model_iter_next(child, &it)) {
+                        gtk_tree_model_get_value(child, &it, col, &value);
+                        if (k->strings) {
+                            const char *s = NULL;
+                            if (G_VALUE_HOLDS_STRING(&value))
+                                s = g_value_get_string(&value);
+                            else if (g_value_transform(&value, &conv))
+                                s = g_value_get_string(&conv);
+                            k->offsets.push_back(k->text.size());
+                            if (s)
+                                k->text += s;
+                            k->text += '\0';
+                        }
+                        else
+                            k->numbers.push_back(g_value_transform(&value, &conv) ? g_value_get_double(&conv) : 0.0);
+                        g_value_unset(&value);
+                    }
+                    if (k->strings)
+                        k->offsets.push_back(k->text.size());
+                    g_value_unset(&conv);
+                    return k;
+                }
+                void refresh() {
+                    if (job) {
+                        again = true;
+                        return;
+                    }
+                    if (sort_column >= 0 && !sort_keys)
+                        sort_keys = snapshot(sort_column);
+                    if (!needle.empty() && !filter_keys)
+                        filter_keys = snapshot(filter_column);
+
+                    job = new Job();
+                    job->data = this;
+                    job->self = G_OBJECT(g_object_ref(self));
+                    job->generation = generation;
+                    job->rows = gtk_tree_model_iter_n_children(child, NULL);
+                    job->blocks = pool->Threads() * 4;
+                    if (sort_column >= 0)
+                        job->sort = sort_keys;
+                    if (!needle.empty())
+                        job->filter = filter_keys;
+                    job->descending = descending;
+                    job->needle = needle;
+                    if (!pool->Post(&Job::run, job)) {
+                        g_object_unref(job->self);
+                        delete job;
+                        job = NULL;
+                    }
+                }
+                void finished(Job *j) {
+                    job = NULL;
+                    if (j->generation == generation)
+                        apply(j->result);
+                    else
+                        again = true;
+                    if (again) {
+                        again = false;
+                        refresh();
+                    }
+                }
+                // shows the child rows in order
+                void apply(std::vector<int> &order) {
+                    int children = gtk_tree_model_iter_n_children(child, NULL);
+                    if (identity) {
+                        map.resize(rows);
+                        for (int r = 0; r < rows; ++r)
+                            map[r] = r;
+                        identity = false;
+                    }
+
+                    std::vector<char> shown(children, 0);
+                    for (size_t i = 0; i < order.size(); ++i)
+                        shown[order[i]] = 1;
+
+                    // the rows hidden by the filter are removed from the last one, so the positions of
+                    // the others don't change
+                    std::vector<int> kept;
+                    kept.reserve(order.size());
+                    for (size_t p = 0; p < map.size(); ++p)
+                        if (shown[map[p]])
+                            kept.push_back(map[p]);
+                    map.swap(kept);
+                    rows = map.size();
+                    stamp++;
+                    for (int p = (int)kept.size() - 1; p >= 0; --p)
+                        if (!shown[kept[p]])
+                            emit_deleted(p);
+
+                    // the rows shown by the filter are appended
+                    std::vector<int> pos(children, -1);
+                    for (size_t p = 0; p < map.size(); ++p)
+                        pos[map[p]] = p;
+                    for (size_t i = 0; i < order.size(); ++i) {
+                        if (pos[order[i]] < 0) {
+                            pos[order[i]] = map.size();
+                            map.push_back(order[i]);
+                            rows = map.size();
+                            emit_inserted(rows - 1);
+                        }
+                    }
+
+                    // and everything is moved in place at once
+                    std::vector<int> new_order(order.size());
+                    bool moved = false;
+                    for (size_t i = 0; i < order.size(); ++i) {
+                        new_order[i] = pos[order[i]];
+                        moved = moved || new_order[i] != (int)i;
+                    }
+                    map = order;
+                    if (active())
+                        reindex();
+                    if (moved) {
+                        stamp++;
+                        emit_reordered(new_order);
+                    }
+                    if (!active()) {
+                        identity = true;
+                        std::vector<int>().swap(map);
+                        std::vector<int>().swap(where);
+                    }
+                }
+            };
+
+            Data *data_;
+
+            static WorkerPool *shared_pool() {
+                static WorkerPool pool(0, 256, "sort");
+                return &pool;
+            }
+            static Data *sortable_data(GtkTreeSortable *s) { return static_cast<Data *>(data(GTK_TREE_MODEL(s))); }
+            static gboolean get_sort_column_id(GtkTreeSortable *s, gint *column, GtkSortType *order) {
+                Data *d = sortable_data(s);
+                if (column)
+                    *column = d->sort_column >= 0 ? d->sort_column : GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID;
+                if (order)
+                    *order = d->descending ? GTK_SORT_DESCENDING : GTK_SORT_ASCENDING;
+                return d->sort_column >= 0;
+            }
+            static void set_sort_column_id(GtkTreeSortable *s, gint column, GtkSortType order) {
+                Data *d = sortable_data(s);
+                int col = column >= 0 ? column : -1;
+                if (col == d->sort_column && (order == GTK_SORT_DESCENDING) == d->descending)
+                    return;
+                sort(d, col, order == GTK_SORT_DESCENDING);
+                gtk_tree_sortable_sort_column_changed(s);
+            }
+            static void set_sort_func(GtkTreeSortable *, gint, GtkTreeIterCompareFunc, gpointer, GDestroyNotify) {
+                g_warning("SortFilterModel: custom sort functions are not supported");
+            }
+            static void set_default_sort_func(GtkTreeSortable *, GtkTreeIterCompareFunc, gpointer, GDestroyNotify) {
+                g_warning("SortFilterModel: the default order is the order of the child model");
+            }
+            static gboolean has_default_sort_func(GtkTreeSortable *) { return TRUE; }
+            static void sortable_init(GtkTreeSortableIface *iface) {
+                iface->get_sort_column_id = get_sort_column_id;
+                iface->set_sort_column_id = set_sort_column_id;
+                iface->set_sort_func = set_sort_func;
+                iface->set_default_sort_func = set_default_sort_func;
+                iface->has_default_sort_func = has_default_sort_func;
+            }
+            static GType type() {
+                static GType t = register_subtype("OOGtkSortFilterModel", GTK_TYPE_TREE_SORTABLE, GInterfaceInitFunc(sortable_init));
+                return t;
+            }
+            static void sort(Data *d, int column, bool descending) {
+                if (column != d->sort_column)
+                    d->sort_keys.reset();
+                d->sort_column = column;
+                d->descending = descending;
+                d->refresh();
+            }
+            void unsupported() const { throw std::runtime_error("SortFilterModel is read only, modify the child model"); }
+/// DOXYS_ON
+        public:
+            /// Creates a proxy of child, initially unsorted and unfiltered.
+            SortFilterModel(TreeModel &child /**< a list model, like ListStore */,
+                            WorkerPool *pool = NULL /**< the pool that sorts and filters, NULL for the shared one */) {
+                if (!(gtk_tree_model_get_flags(child) & GTK_TREE_MODEL_LIST_ONLY))
+                    throw std::runtime_error("SortFilterModel: the child must be a list model");
+                data_ = new Data(child, pool ? pool : shared_pool());
+                setup(data_, type());
+                data_->self = *this;
+            }
+
+            /// Sorts the rows on column, a string column is sorted like GTK sorts it (by collation key), the others by numeric value.
+            void Sort(int column, SortType order = SortAscending) {
+                if (column < 0 || column >= gtk_tree_model_get_n_columns(data_->child))
+                    throw std::runtime_error("SortFilterModel: invalid sort column");
+                gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(Obj()), column, (GtkSortType)order);
+            }
+            /// Shows the rows in the order of the child model.
+            void Unsort() {
+                gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(Obj()), GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID, GTK_SORT_ASCENDING);
+            }
+            /// Shows only the rows whose column contains text, ignoring case, an empty text shows all the rows.
+            void Filter(int column, const std::string &text) {
+                if (column < 0 || column >= gtk_tree_model_get_n_columns(data_->child))
+                    throw std::runtime_error("SortFilterModel: invalid filter column");
+                gchar *folded = g_utf8_casefold(text.c_str(), -1);
+                if (column != data_->filter_column)
+                    data_->filter_keys.reset();
+                data_->filter_column = column;
+                data_->needle = folded;
+                g_free(folded);
+                data_->refresh();
+            }
+            /// Returns true while the rows are being sorted or filtered.
+            bool Busy() const { return data_->job != NULL || data_->idle != 0; }
+            /// Returns the index of the child row shown at row.
+            int ChildRow(int row) const { return data_->child_row(checked_row(row)); }
+            /// Sets child to the child row it points to.
+            bool ChildIter(const TreeIter &it, TreeIter &child) const {
+                if (!IsValid(it))
+                    return false;
+                return gtk_tree_model_iter_nth_child(data_->child, &child, NULL, data_->child_row(Row(it)));
+            }
+
+            /// \name TreeModel interface
+            /// A SortFilterModel is read only, these methods throw std::runtime_error.
+            void Remove(const TreeIter &) { unsupported(); }
+            void Set(TreeIter, ...) { unsupported(); }
+            void SetValue(const TreeIter &, int, int) { unsupported(); }
+            void SetValue(const TreeIter &, int, const std::string &) { unsupported(); }
+            void SetValue(const TreeIter &, int, void *) { unsupported(); }
+            void SetValue(const TreeIter &, int, bool) { unsupported(); }
+    };
+}
+
+#endif
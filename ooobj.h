@@ -3,8 +3,11 @@
 
 #include <stdexcept>
 #include <vector>
+#include <algorithm>
 #include <string.h>
 #include "inline_containers.h"
+#include "ooalloc.h"
+#include "ootrace.h"
 
 namespace gtk
 {
@@ -62,6 +65,7 @@ oogtk C++ enums.
 
     struct AbstractDragCbk
     {
+        OOGTK_POOLED
         virtual ~AbstractDragCbk() {}
         virtual bool notify(GtkWidget *w, SelectionData *e) const = 0;
 
@@ -93,6 +97,7 @@ oogtk C++ enums.
 
     struct AbstractCbk
     {
+        OOGTK_POOLED
         virtual ~AbstractCbk() {}
 
         virtual bool notify(GtkWidget *w = NULL, GdkEvent *e = NULL) const = 0;
@@ -255,6 +260,7 @@ oogtk C++ enums.
         public:
             enum ObjectType { InternalObj, ExternalObj, ReferenceObj};
             typedef std::list<AbstractCbk *> CbkList;
+            OOGTK_POOLED
 
             Object() : obj_(NULL), type_(ExternalObj), id_(-1) {}
             /** Get the internal GObject pointer from any gtk::Object.
@@ -273,11 +279,8 @@ oogtk C++ enums.
             virtual ~Object() {
 
                 if (obj_) {
-#ifdef OOGTK_DEBUG
-                std::cerr << "Destructor for " << (void *)obj_ << " type:"
-                          << g_type_name(GTK_OBJECT_TYPE(obj_))  
-                          << " references: " << obj_->ref_count << std::endl;
-#endif
+                    OOGTK_TRACE(TraceDebug, "Destructor for %p type:%s references: %u",
+                                obj_, g_type_name(GTK_OBJECT_TYPE(obj_)), obj_->ref_count);
 
                     if (id_ >= 0 && g_signal_handler_is_connected (obj_, id_))
                         g_signal_handler_disconnect (obj_, id_);
@@ -298,12 +301,15 @@ oogtk C++ enums.
             /** Connect a callback to a signal.
                 This call is used internally from most signal handling calls, you should usually
                 not need to call it directly.
+
+                The callback is owned by the object and deleted when the object is finalized, after
+                its handlers are gone; the same callback can be connected to more signals of the object.
               */
             void Connect(AbstractCbk *e /**< The callback */, const char *signal /**< the signal */) {
                 CbkList *events = (CbkList *) g_object_get_data(obj_, "events");
                 if (!events) {
                     events = new CbkList();
-                    g_object_set_data(obj_, "events", events);
+                    g_object_set_data_full(obj_, "events", events, GDestroyNotify(release_callbacks));
                 }
 
                 bool after = false;
@@ -378,6 +384,15 @@ oogtk C++ enums.
             { Connect(new CbkEvent<T,R,J>(classbase, cbk, data, returncode), signal); }
 
             void Dispose();
+            // the callbacks of a finalized object, a callback connected more times is deleted once
+            static void release_callbacks(CbkList *events) {
+                std::vector<AbstractCbk *> cbks(events->begin(), events->end());
+                std::sort(cbks.begin(), cbks.end());
+                cbks.erase(std::unique(cbks.begin(), cbks.end()), cbks.end());
+                for (size_t i = 0; i < cbks.size(); ++i)
+                    delete cbks[i];
+                delete events;
+            }
             
             void Set(const char *property, gfloat value) {
                 g_object_set(obj_, property, value, NULL);
@@ -452,10 +467,7 @@ oogtk C++ enums.
             long id_;
 
             static void purge(GObject *obj, Object *d) {
-#ifdef OOGTK_DEBUG
-                std::cerr << "Purge called for " << (void *)obj << " type:"
-                          << g_type_name(GTK_OBJECT_TYPE(obj)) << std::endl;
-#endif
+                OOGTK_TRACE(TraceDebug, "Purge called for %p type:%s", obj, g_type_name(GTK_OBJECT_TYPE(obj)));
                 d->Dispose();
             }
         private:
@@ -499,14 +511,9 @@ oogtk C++ enums.
 
     inline void Object::
     Dispose() {
-        if (type_ != ReferenceObj) {
-            if (CbkList *events = (CbkList *) 
-                    g_object_get_data(obj_, "events"))
-                delete events;
-
-            g_object_steal_data(obj_, "events");
+        // the callbacks stay with the object, its handlers may still run after the wrapper is gone
+        if (type_ != ReferenceObj)
             g_object_steal_data(obj_, "object");
-        }
         obj_ = NULL;
     }
 }
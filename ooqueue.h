@@ -0,0 +1,524 @@
+#ifndef OOQUEUE_H
+#define OOQUEUE_H
+
+/**
+ * GG
+ * Bounded lock free queues to pass data between gtk::Thread objects
+ */
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <stddef.h>
+#include <thread>
+#include "oomutex.h"
+#include "oothread.h"
+
+namespace gtk {
+
+/// DOXYS_OFF
+#ifndef OOGTK_CACHELINE
+#define OOGTK_CACHELINE 64
+#endif
+
+/** Parking helper shared by the queues.
+
+The queues never take a lock to move data, a waiter is parked on a Sync only
+when the queue stays full/empty for longer than a short spin, and the other
+side signals the Sync only if someone is actually parked, so the common case
+costs no mutex and no futex wake.
+ */
+class QueueWaiter
+{
+        Sync sync_;
+        std::atomic<int> waiters_;
+    public:
+        QueueWaiter() : waiters_(0) {}
+
+        /// wait until ready() returns true, until the queue is closed or msecs elapse (msecs < 0 means forever).
+        template <typename P>
+        bool Wait(P ready, const std::atomic<bool> &closed, long msecs) {
+            for (int spin = 0; spin < 64; ++spin) {
+                if (ready())
+                    return true;
+                if (closed.load(std::memory_order_acquire))
+                    return false;
+                if (spin > 16)
+                    g_thread_yield();
+            }
+
+            gint64 end = msecs < 0 ? 0 : g_get_monotonic_time() + msecs * G_TIME_SPAN_MILLISECOND;
+            bool result = false;
+
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            sync_.Lock();
+            for (;;) {
+                if (ready()) {
+                    result = true;
+                    break;
+                }
+                if (closed.load(std::memory_order_seq_cst))
+                    break;
+                if (msecs < 0)
+                    sync_.Wait();
+                else {
+                    gint64 left = end - g_get_monotonic_time();
+                    if (left <= 0)
+                        break;
+                    sync_.Wait((long)((left + G_TIME_SPAN_MILLISECOND - 1) / G_TIME_SPAN_MILLISECOND));
+                }
+            }
+            sync_.Unlock();
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+
+            return result;
+        }
+        /// wake the parked threads, if any.
+        void Notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_seq_cst) > 0) {
+                sync_.Lock();
+                sync_.SignalAll();
+                sync_.Unlock();
+            }
+        }
+};
+
+inline size_t queue_capacity(size_t size) {
+    if (size < 2)
+        size = 2;
+
+    size_t cap = 1;
+    while (cap < size)
+        cap <<= 1;
+
+    return cap;
+}
+/// DOXYS_ON
+
+/** A bounded single producer / single consumer queue.
+
+SPSCQueue is a fixed size ring buffer that can be used to pass data from exactly one producer thread to exactly one consumer thread without locks. The capacity is rounded up to the next power of two.
+
+Every operation exists in three variants:
+- TryPush()/TryPop() never block and return false if the queue is full/empty.
+- Push(const T &, long)/Pop(T &, long) wait at most the given amount of milliseconds.
+- Push(const T &)/Pop(T &) wait until they succeed or until the queue is closed with SPSCQueue::Close().
+
+The timed variants are the natural companion of Thread::Running(), a worker can poll its running state between two timed waits, while SPSCQueue::Close() is the way to wake immediately a thread blocked forever.
+
+\example
+#include "oogtk.h"
+#include "oothread.h"
+#include "ooqueue.h"
+
+class Consumer : public gtk::Thread {
+    gtk::SPSCQueue<Sample> &queue_;
+    void worker_thread() {
+        Sample s;
+        while (Running()) {
+            if (queue_.Pop(s, 100)) // wake up at least every 100ms to check Running()
+                process(s);
+        }
+    }
+public:
+    Consumer(gtk::SPSCQueue<Sample> &q) : Thread("consumer"), queue_(q) { Start(); }
+};
+\endexample
+*/
+template <typename T>
+class SPSCQueue
+{
+/// DOXYS_OFF
+        alignas(OOGTK_CACHELINE) std::atomic<size_t> head_; // next slot to read, written by the consumer
+        alignas(OOGTK_CACHELINE) std::atomic<size_t> tail_; // next slot to write, written by the producer
+        alignas(OOGTK_CACHELINE) size_t cached_head_; // producer copy of head_
+        alignas(OOGTK_CACHELINE) size_t cached_tail_; // consumer copy of tail_
+        size_t mask_;
+        std::vector<T> buffer_;
+        std::atomic<bool> closed_;
+        QueueWaiter not_empty_;
+        QueueWaiter not_full_;
+
+        SPSCQueue(const SPSCQueue &);
+        SPSCQueue &operator=(const SPSCQueue &);
+/// DOXYS_ON
+    public:
+        /// Creates a queue able to hold at least size elements.
+        explicit SPSCQueue(size_t size /**< minimum capacity of the queue, rounded to the next power of two */) :
+            head_(0), tail_(0), cached_head_(0), cached_tail_(0),
+            mask_(queue_capacity(size) - 1), buffer_(mask_ + 1), closed_(false) {}
+
+        /// Appends an element to the queue, returns false if the queue is full. Producer side only.
+        bool TryPush(const T &item) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+
+            if (tail - cached_head_ > mask_) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ > mask_)
+                    return false;
+            }
+            buffer_[tail & mask_] = item;
+            tail_.store(tail + 1, std::memory_order_release);
+            not_empty_.Notify();
+            return true;
+        }
+        /// Removes the oldest element of the queue, returns false if the queue is empty. Consumer side only.
+        bool TryPop(T &item) {
+            size_t head = head_.load(std::memory_order_relaxed);
+
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_)
+                    return false;
+            }
+            item = buffer_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            not_full_.Notify();
+            return true;
+        }
+        /// Appends an element waiting at most msecs milliseconds for a free slot.
+        /// \retval false if the queue is still full after the timeout or if it has been closed.
+        bool Push(const T &item, long msecs) {
+            if (Closed())
+                return false;
+
+            bool done = false;
+            not_full_.Wait([&]() { return done = TryPush(item); }, closed_, msecs);
+            return done;
+        }
+        /// Appends an element waiting for a free slot, returns false only if the queue is closed.
+        bool Push(const T &item) { return Push(item, -1); }
+        /// Removes the oldest element waiting at most msecs milliseconds for it.
+        /// \retval false if the queue is still empty after the timeout or if it has been closed and drained.
+        bool Pop(T &item, long msecs) {
+            bool done = false;
+            not_empty_.Wait([&]() { return done = TryPop(item); }, closed_, msecs);
+            return done || TryPop(item);
+        }
+        /// Removes the oldest element waiting for it, returns false only if the queue is closed and drained.
+        bool Pop(T &item) { return Pop(item, -1); }
+
+        /** Closes the queue.
+After this call every thread blocked in Push() or Pop() is woken up, Push() fails, while Pop() keeps returning the elements still in the queue until it is empty.
+         */
+        void Close() {
+            closed_.store(true, std::memory_order_seq_cst);
+            not_empty_.Notify();
+            not_full_.Notify();
+        }
+        /// Returns true if SPSCQueue::Close() has been called.
+        bool Closed() const { return closed_.load(std::memory_order_acquire); }
+        /// Returns the number of elements in the queue, the value is only a snapshot if the other side is active.
+        size_t Size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+        /// Returns true if the queue is empty.
+        bool Empty() const { return Size() == 0; }
+        /// Returns the number of elements the queue can hold.
+        size_t Capacity() const { return mask_ + 1; }
+};
+
+/** A bounded multiple producer / multiple consumer queue.
+
+MPMCQueue is a lock free fixed size ring buffer that can be shared by any number of producer and consumer threads, every slot carries a sequence number so producers and consumers only contend on a single atomic counter each. The capacity is rounded up to the next power of two.
+
+The API is the same of SPSCQueue: TryPush()/TryPop() never block, Push()/Pop() with a timeout wait at most the given amount of milliseconds and Push()/Pop() without timeout wait until they succeed or the queue is closed through MPMCQueue::Close().
+*/
+template <typename T>
+class MPMCQueue
+{
+/// DOXYS_OFF
+        struct Cell {
+            std::atomic<size_t> seq;
+            T data;
+        };
+
+        alignas(OOGTK_CACHELINE) std::atomic<size_t> head_;
+        alignas(OOGTK_CACHELINE) std::atomic<size_t> tail_;
+        alignas(OOGTK_CACHELINE) size_t mask_;
+        Cell *cells_;
+        std::atomic<bool> closed_;
+        QueueWaiter not_empty_;
+        QueueWaiter not_full_;
+
+        MPMCQueue(const MPMCQueue &);
+        MPMCQueue &operator=(const MPMCQueue &);
+/// DOXYS_ON
+    public:
+        /// Creates a queue able to hold at least size elements.
+        explicit MPMCQueue(size_t size /**< minimum capacity of the queue, rounded to the next power of two */) :
+            head_(0), tail_(0), mask_(queue_capacity(size) - 1), closed_(false) {
+            cells_ = new Cell[mask_ + 1];
+            for (size_t i = 0; i <= mask_; ++i)
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        ~MPMCQueue() { delete [] cells_; }
+
+        /// Appends an element to the queue, returns false if the queue is full.
+        bool TryPush(const T &item) {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+
+            for (;;) {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.data = item;
+                        cell.seq.store(pos + 1, std::memory_order_release);
+                        not_empty_.Notify();
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        /// Removes the oldest element of the queue, returns false if the queue is empty.
+        bool TryPop(T &item) {
+            size_t pos = head_.load(std::memory_order_relaxed);
+
+            for (;;) {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        item = cell.data;
+                        cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                        not_full_.Notify();
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        /// Appends an element waiting at most msecs milliseconds for a free slot.
+        /// \retval false if the queue is still full after the timeout or if it has been closed.
+        bool Push(const T &item, long msecs) {
+            if (Closed())
+                return false;
+
+            bool done = false;
+            not_full_.Wait([&]() { return done = TryPush(item); }, closed_, msecs);
+            return done;
+        }
+        /// Appends an element waiting for a free slot, returns false only if the queue is closed.
+        bool Push(const T &item) { return Push(item, -1); }
+        /// Removes the oldest element waiting at most msecs milliseconds for it.
+        /// \retval false if the queue is still empty after the timeout or if it has been closed and drained.
+        bool Pop(T &item, long msecs) {
+            bool done = false;
+            not_empty_.Wait([&]() { return done = TryPop(item); }, closed_, msecs);
+            return done || TryPop(item);
+        }
+        /// Removes the oldest element waiting for it, returns false only if the queue is closed and drained.
+        bool Pop(T &item) { return Pop(item, -1); }
+
+        /// Closes the queue, waking up every blocked thread. \sa SPSCQueue::Close()
+        void Close() {
+            closed_.store(true, std::memory_order_seq_cst);
+            not_empty_.Notify();
+            not_full_.Notify();
+        }
+        /// Returns true if MPMCQueue::Close() has been called.
+        bool Closed() const { return closed_.load(std::memory_order_acquire); }
+        /// Returns an approximation of the number of elements in the queue.
+        size_t Size() const {
+            size_t tail = tail_.load(std::memory_order_acquire), head = head_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        /// Returns true if the queue looks empty.
+        bool Empty() const { return Size() == 0; }
+        /// Returns the number of elements the queue can hold.
+        size_t Capacity() const { return mask_ + 1; }
+};
+
+/** A fixed set of threads running the tasks posted by any thread.
+
+The tasks are methods of objects, they are queued in a MPMCQueue and run by the first idle worker. WorkerPool::ForEach() splits a loop between the workers and the calling thread and returns when every iteration is done, it's the building block of the parallel algorithms of the library (see SortFilterModel).
+
+Destroying the pool closes the queue, the workers run the tasks already queued and exit.
+
+\example
+class Scaler {
+    std::vector<Image> &images_;
+    void scale(int i) { images_[i].Scale(128, 128); }
+public:
+    Scaler(std::vector<Image> &images) : images_(images) {}
+    void Run(gtk::WorkerPool &pool) { pool.ForEach(images_.size(), &Scaler::scale, this); }
+};
+\endexample
+*/
+class WorkerPool
+{
+/// DOXYS_OFF
+        struct Task {
+            virtual ~Task() {}
+            virtual void Run() = 0;
+            // called by the worker when Run() returns
+            virtual void Done() { delete this; }
+        };
+        template <typename T>
+        struct TaskCbk : public Task {
+            T *obj_;
+            void (T::*fnc_)();
+            TaskCbk(void (T::*fnc)(), T *obj) : obj_(obj), fnc_(fnc) {}
+            void Run() { (obj_->*fnc_)(); }
+        };
+        template <typename T, typename A>
+        struct ArgTaskCbk : public Task {
+            T *obj_;
+            void (T::*fnc_)(A);
+            A arg_;
+            ArgTaskCbk(void (T::*fnc)(A), T *obj, const A &arg) : obj_(obj), fnc_(fnc), arg_(arg) {}
+            void Run() { (obj_->*fnc_)(arg_); }
+        };
+        // the iterations of a ForEach() call, shared by the caller and the workers helping it,
+        // the last one releasing it deletes it, so a late worker never touches the caller data
+        struct Batch : public Task {
+            std::atomic<int> next_, left_, refs_;
+            int count_;
+            Sync sync_;
+
+            Batch(int count) : next_(0), left_(count), refs_(1), count_(count) {}
+            virtual void item(int i) = 0;
+
+            void Run() { drain(); }
+            void Done() { release(); }
+            void drain() {
+                int i;
+                while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < count_) {
+                    try {
+                        item(i);
+                    }
+                    catch (std::exception &e) {
+                        OOGTK_TRACE(TraceError, "exception in a WorkerPool loop: %s", e.what());
+                    }
+                    if (left_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        sync_.Lock();
+                        sync_.SignalAll();
+                        sync_.Unlock();
+                    }
+                }
+            }
+            void wait() {
+                sync_.Lock();
+                while (left_.load(std::memory_order_acquire) > 0)
+                    sync_.Wait();
+                sync_.Unlock();
+            }
+            void release() {
+                if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+        };
+        template <typename T>
+        struct BatchCbk : public Batch {
+            T *obj_;
+            void (T::*fnc_)(int);
+            BatchCbk(int count, void (T::*fnc)(int), T *obj) : Batch(count), obj_(obj), fnc_(fnc) {}
+            void item(int i) { (obj_->*fnc_)(i); }
+        };
+
+        class Worker : public Thread {
+                MPMCQueue<Task *> &queue_;
+                void worker_thread() {
+                    Task *t;
+                    while (queue_.Pop(t)) {
+                        try {
+                            t->Run();
+                        }
+                        catch (std::exception &e) {
+                            OOGTK_TRACE(TraceError, "exception in a WorkerPool task: %s", e.what());
+                        }
+                        t->Done();
+                    }
+                }
+            public:
+                Worker(MPMCQueue<Task *> &queue, const std::string &name) : Thread(name), queue_(queue) { Start(); }
+        };
+
+        MPMCQueue<Task *> queue_;
+        std::vector<Worker *> workers_;
+
+        bool post(Task *t) {
+            if (!queue_.Push(t)) {
+                delete t;
+                return false;
+            }
+            return true;
+        }
+        WorkerPool(const WorkerPool &);
+        WorkerPool &operator=(const WorkerPool &);
+/// DOXYS_ON
+    public:
+        /// Starts the worker threads.
+        explicit WorkerPool(int threads = 0 /**< number of workers, 0 means one for every CPU */,
+                            size_t queue = 1024 /**< the number of tasks that can be queued */,
+                            const std::string &name = "worker" /**< the name of the threads */) : queue_(queue) {
+            if (threads <= 0)
+                threads = std::thread::hardware_concurrency();
+            if (threads <= 0)
+                threads = 2;
+            for (int i = 0; i < threads; ++i)
+                workers_.push_back(new Worker(queue_, name));
+        }
+        /// Waits for the queued tasks and stops the workers.
+        ~WorkerPool() {
+            queue_.Close();
+            for (size_t i = 0; i < workers_.size(); ++i) {
+                workers_[i]->Join();
+                delete workers_[i];
+            }
+        }
+        /// Returns the number of worker threads.
+        int Threads() const { return workers_.size(); }
+        /// Returns the number of tasks waiting for a worker.
+        size_t Pending() const { return queue_.Size(); }
+
+        /** Queues a call to base->fnc() in a worker thread.
+
+The call waits if the queue is full.
+\retval false if the pool is being destroyed, the task is not run.
+        */
+        template <typename T>
+        bool Post(void (T::*fnc)(), T *base) { return post(new TaskCbk<T>(fnc, base)); }
+        /// Queues a call to base->fnc(arg) in a worker thread, the argument is copied.
+        template <typename T, typename A>
+        bool Post(void (T::*fnc)(A), T *base, const A &arg) { return post(new ArgTaskCbk<T, A>(fnc, base, arg)); }
+
+        /** Calls base->fnc(i) for every i from 0 to count - 1 in parallel.
+
+The calling thread runs the iterations too, so a ForEach() called from a task of the same pool can't deadlock, the method returns when every iteration is completed. The iterations are handed out one at a time, use coarse iterations (a block of rows rather than a row) for cheap work.
+        */
+        template <typename T>
+        void ForEach(int count /**< number of iterations */,
+                     void (T::*fnc)(int) /**< the method called for every iteration */,
+                     T *base /**< the object the method belongs to */) {
+            if (count <= 0)
+                return;
+
+            Batch *b = new BatchCbk<T>(count, fnc, base);
+            int helpers = count - 1 < Threads() ? count - 1 : Threads();
+            for (int i = 0; i < helpers; ++i) {
+                b->refs_.fetch_add(1, std::memory_order_relaxed);
+                if (!queue_.TryPush(b)) {
+                    b->refs_.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            b->drain();
+            b->wait();
+            b->release();
+        }
+};
+
+}
+#endif
@@ -0,0 +1,367 @@
+#ifndef OOSEARCH_H
+#define OOSEARCH_H
+
+/**
+ * GG
+ * An incremental search index on a column of a list model, for the
+ * interactive search of TreeView and for EntryCompletion.
+ */
+
+#include "ootree.h"
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string.h>
+
+namespace gtk {
+
+/** An index of the strings in a column of a list model.
+
+The interactive search of a TreeView and the completion of an EntryCompletion compare the key with every row of the model, normalizing and case folding the string of the row at every comparison, so on a model with a few hundred thousand rows every keystroke takes hundreds of milliseconds. A SearchIndex keeps the folded strings of a column in a sorted map (for prefix searches) and, in Substring mode, in a trigram index; the matching rows are computed once per key and the search functions only look up the row in the result.
+
+The index follows the changes of the model through its row-inserted, row-changed, row-deleted and rows-reordered signals, so it stays valid while the model is modified. Only list models (ListStore, ColumnarModel...) are supported.
+
+\example
+gtk::SearchIndex index(symbols, 0, gtk::SearchIndex::Prefix);
+completion.Model(&symbols);
+completion.TextColumn(0);
+index.Attach(completion);
+
+gtk::SearchIndex messages(log, 1, gtk::SearchIndex::Substring);
+messages.Attach(tv);
+\endexample
+
+\note When the index is destroyed the views and completions it's attached to fall back to a plain case insensitive prefix match.
+*/
+    class SearchIndex
+    {
+        public:
+            /// How the key is matched against the strings of the column.
+            enum Mode {
+                Prefix /**< the string starts with the key, like the default GTK searches */,
+                Substring /**< the string contains the key, uses a trigram index */
+            };
+/// DOXYS_OFF
+        private:
+            struct Entry {
+                std::string key; // normalized and case folded
+                gpointer handle;
+                bool used;
+            };
+            // the data given to GTK, it survives the index and falls back to a plain match
+            struct Link {
+                SearchIndex *index;
+                int column;
+            };
+
+            GtkTreeModel *model_;
+            int column_;
+            Mode mode_;
+            bool persist_;
+            gulong handlers_[4];
+            std::vector<Entry> entries_;
+            std::vector<int> free_;
+            std::vector<int> order_; // row -> entry
+            std::unordered_map<gpointer, int> handles_;
+            std::multimap<std::string, int> prefixes_;
+            std::unordered_map<guint32, std::vector<int> > trigrams_;
+            std::vector<Link *> links_;
+            // the result for the last key
+            std::string last_;
+            bool cached_;
+            std::vector<char> marks_;
+            std::vector<int> marked_;
+
+            static std::string fold(const char *s) {
+                if (!s)
+                    return std::string();
+                gchar *n = g_utf8_normalize(s, -1, G_NORMALIZE_ALL);
+                gchar *f = g_utf8_casefold(n ? n : s, -1);
+                std::string result(f);
+                g_free(f);
+                g_free(n);
+                return result;
+            }
+            static guint32 trigram(const std::string &s, size_t i) {
+                return ((guint32)(guchar)s[i] << 16) | ((guint32)(guchar)s[i + 1] << 8) | (guchar)s[i + 2];
+            }
+
+            void index(int e) {
+                const std::string &k = entries_[e].key;
+                prefixes_.insert(std::make_pair(k, e));
+                if (mode_ == Substring)
+                    for (size_t i = 0; i + 3 <= k.size(); ++i) {
+                        std::vector<int> &p = trigrams_[trigram(k, i)];
+                        if (p.empty() || p.back() != e)
+                            p.push_back(e);
+                    }
+            }
+            void unindex(int e) {
+                const std::string &k = entries_[e].key;
+                std::multimap<std::string, int>::iterator it = prefixes_.lower_bound(k);
+                for (; it != prefixes_.end() && it->first == k; ++it)
+                    if (it->second == e) {
+                        prefixes_.erase(it);
+                        break;
+                    }
+                if (mode_ == Substring)
+                    for (size_t i = 0; i + 3 <= k.size(); ++i) {
+                        std::unordered_map<guint32, std::vector<int> >::iterator t = trigrams_.find(trigram(k, i));
+                        if (t == trigrams_.end())
+                            continue;
+                        std::vector<int> &p = t->second;
+                        for (size_t j = 0; j < p.size(); ++j)
+                            if (p[j] == e) {
+                                p[j] = p.back();
+                                p.pop_back();
+                                break;
+                            }
+                        if (p.empty())
+                            trigrams_.erase(t);
+                    }
+            }
+            std::string read(GtkTreeIter *it) {
+                GValue value;
+                memset(&value, 0, sizeof(value));
+                gtk_tree_model_get_value(model_, it, column_, &value);
+                std::string result = G_VALUE_HOLDS_STRING(&value) ? fold(g_value_get_string(&value)) : std::string();
+                g_value_unset(&value);
+                return result;
+            }
+            int add(int row, GtkTreeIter *it) {
+                int e;
+                if (free_.empty()) {
+                    e = entries_.size();
+                    entries_.push_back(Entry());
+                    marks_.push_back(0);
+                }
+                else {
+                    e = free_.back();
+                    free_.pop_back();
+                }
+                Entry &entry = entries_[e];
+                entry.key = read(it);
+                entry.handle = persist_ ? it->user_data : NULL;
+                entry.used = true;
+                if (persist_)
+                    handles_[entry.handle] = e;
+                order_.insert(order_.begin() + row, e);
+                index(e);
+                return e;
+            }
+            void remove(int row) {
+                int e = order_[row];
+                unindex(e);
+                if (persist_)
+                    handles_.erase(entries_[e].handle);
+                entries_[e].used = false;
+                entries_[e].key.clear();
+                free_.push_back(e);
+                order_.erase(order_.begin() + row);
+            }
+
+            static int row(GtkTreePath *path) { return gtk_tree_path_get_indices(path)[0]; }
+            static void row_inserted(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *it, SearchIndex *s) {
+                s->cached_ = false;
+                s->add(row(path), it);
+            }
+            static void row_changed(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *it, SearchIndex *s) {
+                int e = s->order_[row(path)];
+                std::string key = s->read(it);
+                if (key == s->entries_[e].key)
+                    return;
+                s->cached_ = false;
+                s->unindex(e);
+                s->entries_[e].key.swap(key);
+                s->index(e);
+            }
+            static void row_deleted(GtkTreeModel *, GtkTreePath *path, SearchIndex *s) {
+                s->cached_ = false;
+                s->remove(row(path));
+            }
+            static void rows_reordered(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, gint *new_order, SearchIndex *s) {
+                if (gtk_tree_path_get_depth(path) != 0)
+                    return;
+                std::vector<int> order(s->order_.size());
+                for (size_t i = 0; i < order.size(); ++i)
+                    order[i] = s->order_[new_order[i]];
+                s->order_.swap(order);
+            }
+
+            void mark(int e) {
+                if (!marks_[e]) {
+                    marks_[e] = 1;
+                    marked_.push_back(e);
+                }
+            }
+            // computes the entries matching key
+            void search(const char *key) {
+                for (size_t i = 0; i < marked_.size(); ++i)
+                    marks_[marked_[i]] = 0;
+                marked_.clear();
+                last_ = key;
+                cached_ = true;
+
+                std::string k = fold(key);
+                if (mode_ == Prefix) {
+                    std::multimap<std::string, int>::const_iterator it = prefixes_.lower_bound(k);
+                    for (; it != prefixes_.end() && it->first.compare(0, k.size(), k) == 0; ++it)
+                        mark(it->second);
+                }
+                else if (k.size() < 3) {
+                    for (size_t e = 0; e < entries_.size(); ++e)
+                        if (entries_[e].used && entries_[e].key.find(k) != std::string::npos)
+                            mark(e);
+                }
+                else {
+                    // the candidates are the entries of the rarest trigram of the key
+                    const std::vector<int> *best = NULL;
+                    for (size_t i = 0; i + 3 <= k.size(); ++i) {
+                        std::unordered_map<guint32, std::vector<int> >::const_iterator t = trigrams_.find(trigram(k, i));
+                        if (t == trigrams_.end())
+                            return;
+                        if (!best || t->second.size() < best->size())
+                            best = &t->second;
+                    }
+                    for (size_t i = 0; i < best->size(); ++i)
+                        if (entries_[(*best)[i]].key.find(k) != std::string::npos)
+                            mark((*best)[i]);
+                }
+            }
+            int entry(GtkTreeIter *it) const {
+                if (persist_) {
+                    std::unordered_map<gpointer, int>::const_iterator h = handles_.find(it->user_data);
+                    return h == handles_.end() ? -1 : h->second;
+                }
+                GtkTreePath *path = gtk_tree_model_get_path(model_, it);
+                int r = path ? gtk_tree_path_get_indices(path)[0] : -1;
+                gtk_tree_path_free(path);
+                return r >= 0 && r < (int)order_.size() ? order_[r] : -1;
+            }
+            bool matches(const char *key, GtkTreeIter *it) {
+                if (!key)
+                    return false;
+                if (!cached_ || last_ != key)
+                    search(key);
+                int e = entry(it);
+                return e >= 0 && marks_[e];
+            }
+
+            // used when the index is gone
+            static bool plain_match(GtkTreeModel *model, int column, const char *key, GtkTreeIter *it) {
+                GValue value;
+                memset(&value, 0, sizeof(value));
+                gtk_tree_model_get_value(model, it, column, &value);
+                bool result = false;
+                if (G_VALUE_HOLDS_STRING(&value) && key) {
+                    std::string s = fold(g_value_get_string(&value)), k = fold(key);
+                    result = s.compare(0, k.size(), k) == 0;
+                }
+                g_value_unset(&value);
+                return result;
+            }
+            static gboolean search_equal(GtkTreeModel *model, gint column, const gchar *key, GtkTreeIter *it, gpointer data) {
+                Link *l = static_cast<Link *>(data);
+                // FALSE means that the row matches
+                if (l->index && l->index->model_ == model && l->index->column_ == column)
+                    return !l->index->matches(key, it);
+                return !plain_match(model, column, key, it);
+            }
+            static gboolean completion_match(GtkEntryCompletion *completion, const gchar *key, GtkTreeIter *it, gpointer data) {
+                Link *l = static_cast<Link *>(data);
+                GtkTreeModel *model = gtk_entry_completion_get_model(completion);
+                if (l->index && l->index->model_ == model)
+                    return l->index->matches(key, it);
+                return plain_match(model, l->column, key, it);
+            }
+            static void release(gpointer data) {
+                Link *l = static_cast<Link *>(data);
+                if (l->index) {
+                    std::vector<Link *> &links = l->index->links_;
+                    for (size_t i = 0; i < links.size(); ++i)
+                        if (links[i] == l) {
+                            links.erase(links.begin() + i);
+                            break;
+                        }
+                }
+                delete l;
+            }
+            Link *link() {
+                Link *l = new Link;
+                l->index = this;
+                l->column = column_;
+                links_.push_back(l);
+                return l;
+            }
+
+            SearchIndex(const SearchIndex &);
+            SearchIndex &operator=(const SearchIndex &);
+/// DOXYS_ON
+        public:
+            /// Indexes the strings in column of model.
+            SearchIndex(TreeModel &model /**< a list model */,
+                        int column /**< a string column */,
+                        Mode mode = Prefix /**< how keys are matched */) :
+                model_(model), column_(column), mode_(mode), cached_(false) {
+                GtkTreeModelFlags flags = gtk_tree_model_get_flags(model_);
+                if (!(flags & GTK_TREE_MODEL_LIST_ONLY))
+                    throw std::runtime_error("SearchIndex: only list models can be indexed");
+                if (column < 0 || column >= gtk_tree_model_get_n_columns(model_))
+                    throw std::runtime_error("SearchIndex: invalid column");
+                persist_ = (flags & GTK_TREE_MODEL_ITERS_PERSIST) != 0;
+                g_object_ref(model_);
+
+                int rows = gtk_tree_model_iter_n_children(model_, NULL);
+                entries_.reserve(rows);
+                order_.reserve(rows);
+                GtkTreeIter it;
+                int r = 0;
+                for (bool ok = gtk_tree_model_get_iter_first(model_, &it); ok; ok = gtk_tree_model_iter_next(model_, &it))
+                    add(r++, &it);
+
+                handlers_[0] = g_signal_connect(model_, "row-inserted", GCallback(row_inserted), this);
+                handlers_[1] = g_signal_connect(model_, "row-changed", GCallback(row_changed), this);
+                handlers_[2] = g_signal_connect(model_, "row-deleted", GCallback(row_deleted), this);
+                handlers_[3] = g_signal_connect(model_, "rows-reordered", GCallback(rows_reordered), this);
+            }
+            ~SearchIndex() {
+                for (size_t i = 0; i < links_.size(); ++i)
+                    links_[i]->index = NULL;
+                for (int i = 0; i < 4; ++i)
+                    g_signal_handler_disconnect(model_, handlers_[i]);
+                g_object_unref(model_);
+            }
+
+            /// Makes the interactive search of view use the index, the view must show the indexed model.
+            void Attach(TreeView &view) {
+                gtk_tree_view_set_search_column(view, column_);
+                gtk_tree_view_set_search_equal_func(view, search_equal, link(), release);
+            }
+            /// Makes completion use the index to match its key, the completion must use the indexed model.
+            void Attach(EntryCompletion &completion) {
+                gtk_entry_completion_set_match_func(completion, completion_match, link(), release);
+            }
+
+            /// Returns the indexes of the rows matching text, in the order of the model.
+            std::vector<int> Find(const std::string &text) {
+                search(text.c_str());
+                std::vector<int> rows;
+                for (size_t r = 0; r < order_.size(); ++r)
+                    if (marks_[order_[r]])
+                        rows.push_back(r);
+                return rows;
+            }
+            /// Returns true if the row at it matches text.
+            bool Matches(const TreeIter &it, const std::string &text) {
+                return matches(text.c_str(), const_cast<TreeIter *>(&it));
+            }
+            /// Returns the number of indexed rows.
+            size_t Size() const { return order_.size(); }
+            /// Returns the indexed column.
+            int Column() const { return column_; }
+            /// Returns the match mode.
+            Mode MatchMode() const { return mode_; }
+    };
+}
+
+#endif
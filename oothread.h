@@ -7,9 +7,36 @@
 #include <glib.h>
 #include <string.h>
 #include <iostream>
+#include <vector>
+#include "oomutex.h"
+#include "ootrace.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+#endif
 
 namespace gtk {
 
+/// Scheduling priority of a Thread, see Thread::Priority(ThreadPriority).
+enum ThreadPriority {
+    ThreadPriorityIdle /**< runs only when the CPU has nothing else to do (nice 19 on Linux) */,
+    ThreadPriorityLow /**< lower than the GUI thread (nice 10 on Linux) */,
+    ThreadPriorityNormal /**< the default priority */,
+    ThreadPriorityHigh /**< higher than the GUI thread (nice -10 on Linux, needs CAP_SYS_NICE to be raised) */,
+    ThreadPriorityRealtime /**< real time FIFO scheduling (SCHED_FIFO on posix systems, needs the proper privileges) */
+};
+
+/// A list of CPU indexes, used by Thread::Affinity().
+typedef std::vector<int> CpuSet;
+
 /** A simple Thread class
 
 This class implement the thread paradigm in an object oriented clean way.
@@ -55,9 +82,12 @@ int main()
 */
 class Thread
 {
-    static /*__thread*/ thread_local char thread_name[40];
-    
 /// DOXYS_OFF    
+    static char *thread_name() {
+        static thread_local char name[40];
+        return name;
+    }
+
     static GPrivate *PrivateKey() {
 #if GLIB_MINOR_VERSION < 32
         static GPrivate *key = NULL;
@@ -76,13 +106,31 @@ class Thread
     bool done_;
     bool detached_;
     GThread *th_;
+    // scheduling setup, protected by setup_ since it can be changed while the thread runs
+    mutable Mutex setup_;
+    CpuSet cpus_;
+    ThreadPriority priority_;
+    bool attached_;
+#ifdef WIN32
+    HANDLE native_;
+#else
+    pthread_t native_;
+#ifdef __linux__
+    pid_t tid_;
+#endif
+#endif
 /// DOXYS_ON
 protected:
     /// The thread entry point function, your class should derive from thread and redefine this.
     virtual void worker_thread() = 0;
 public:
-    // set the name of the thread
-    void Name(const std::string &n /**< a string that will be used as thread name */) { name_ = n; }
+    /// set the name of the thread, if the thread is running the name is also applied to the OS thread.
+    void Name(const std::string &n /**< a string that will be used as thread name */) {
+        AutoMutex lock(setup_);
+        name_ = n;
+        if (attached_)
+            apply_name();
+    }
     /// get the name of the thread (as specified in his constructor)
     const std::string &Name() const { return name_; }
     /// set the current thread name
@@ -91,15 +139,18 @@ public:
                 static_cast < Thread * >(g_private_get(PrivateKey()))) 
             thr->name_ = n;
          else
-            strncpy(thread_name, n.c_str(), sizeof(thread_name) - 1);
+            strncpy(thread_name(), n.c_str(), 39);
+
+         set_os_name(n);
+         Trace::ThreadName(n);
     }
     /// get the current running thread name
     static std::string CurrentThreadName() {
         if (Thread *thr = 
                 static_cast < Thread * >(g_private_get(PrivateKey()))) 
             return (*thr).name_;
-        else if (*thread_name)
-            return thread_name;
+        else if (*thread_name())
+            return thread_name();
         else
             return "Main";
     }
@@ -113,7 +164,8 @@ public:
     }
     /// create a new thread with an optional name
     Thread(const std::string &name = "child thread") : 
-        name_(name), running_(false), done_(true), detached_(false), th_(0) {
+        name_(name), running_(false), done_(true), detached_(false), th_(0),
+        priority_(ThreadPriorityNormal), attached_(false) {
     }
 
     virtual ~Thread() {};
@@ -148,7 +200,7 @@ public:
             g_usleep(10000);
 
         if (die_wait >= 100) {
-            std::cerr << "thread " << Name() << " refused to die - and cancelling not implemented!" << std::endl;
+            OOGTK_TRACE(TraceError, "thread %s refused to die - and cancelling not implemented!", Name());
         }
         else if (!detached_)
             g_thread_join(th_);
@@ -168,9 +220,48 @@ public:
         detached_ = true;
     }
 
+    /** Asks the thread to stop without waiting for it.
+
+Thread::Running() returns false from now on, Thread::Join() waits for the thread to return.
+     */
+    void Cancel() { running_ = false; }
+
     /// Check if the thread is running
     bool Running() const { return running_; }
 
+    /** Pins the thread to a set of CPUs.
+
+The affinity can be set before Thread::Start(), in this case it's applied by the new thread before Thread::worker_thread() is called, or while the thread is running. An empty CpuSet lets the thread run on every CPU.
+
+\example
+acquisition.Affinity(make_vector(2)(3)); // keep the acquisition thread away from the GUI thread on CPU 0
+acquisition.Start();
+\endexample
+\retval false if the thread is running and the affinity cannot be applied, or if the platform doesn't support it.
+     */
+    bool Affinity(const CpuSet &cpus /**< the indexes of the CPUs the thread may run on */) {
+        AutoMutex lock(setup_);
+        cpus_ = cpus;
+        return !attached_ || apply_affinity();
+    }
+    /// Pins the thread to a single CPU. \sa Thread::Affinity(const CpuSet &)
+    bool Affinity(int cpu /**< index of the CPU the thread should run on */) { return Affinity(CpuSet(1, cpu)); }
+    /// Returns the CPU set specified with Thread::Affinity(), empty if the thread can run on every CPU.
+    CpuSet Affinity() const { AutoMutex lock(setup_); return cpus_; }
+
+    /** Sets the scheduling priority of the thread.
+
+Like Thread::Affinity() this can be called before Thread::Start() or while the thread is running. Raising the priority above ThreadPriorityNormal usually requires special privileges.
+\retval false if the thread is running and the priority cannot be applied.
+     */
+    bool Priority(ThreadPriority prio /**< the new priority */) {
+        AutoMutex lock(setup_);
+        priority_ = prio;
+        return !attached_ || apply_priority();
+    }
+    /// Returns the priority specified with Thread::Priority(ThreadPriority).
+    ThreadPriority Priority() const { AutoMutex lock(setup_); return priority_; }
+
     /// Starts a thread    
     /// \retval false if the thread is already running or it cannot be created.
     bool Start() {
@@ -200,8 +291,13 @@ public:
         return true;
     }
 
-    /// Wait for a not detached thread to complete    
-    void Join() { if (!detached_ && th_) g_thread_join(th_); }
+    /// Wait for a not detached thread to complete, it can be called more times.
+    void Join() {
+        if (!detached_ && th_ && g_thread_self() != th_) {
+            g_thread_join(th_);
+            th_ = 0;
+        }
+    }
 
     /// DOXYS_OFF   
 private:    
@@ -211,24 +307,133 @@ private:
         GPrivate *p = PrivateKey();
         g_private_set(p, pThread);
 
+        pThread->attach();
+
         try {
             pThread->worker_thread();
         }
         catch(std::runtime_error &e) {
-            std::cerr << "Exception in threadfunc: " << e.what() << std::endl;
-            //ELOG << "Exception in threadfunc: " << e;
+            OOGTK_TRACE(TraceError, "Exception in threadfunc: %s", e.what());
         }
         catch(...) {
-            std::cerr <<
-                "(thread) unhandled exception caught: (fatal)";
-            //ELOG << "(thread) unhandled exception caught: (fatal)";
+            OOGTK_TRACE(TraceError, "(thread) unhandled exception caught: (fatal)");
         }
 
+        pThread->detach_native();
         pThread->done_ = true;
         pThread->running_ = false;
 
         return NULL;
     }
+
+    // called by the new thread before worker_thread(), applies the OS name and the
+    // scheduling settings requested before Start().
+    void attach() {
+        AutoMutex lock(setup_);
+#ifdef WIN32
+        DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(),
+                        &native_, 0, FALSE, DUPLICATE_SAME_ACCESS);
+#else
+        native_ = pthread_self();
+#ifdef __linux__
+        tid_ = (pid_t)syscall(SYS_gettid);
+#endif
+#endif
+        attached_ = true;
+
+        apply_name();
+        Trace::ThreadName(name_);
+        if (!cpus_.empty())
+            apply_affinity();
+        if (priority_ != ThreadPriorityNormal)
+            apply_priority();
+    }
+    void detach_native() {
+        AutoMutex lock(setup_);
+        attached_ = false;
+#ifdef WIN32
+        CloseHandle(native_);
+#endif
+    }
+    // the OS thread name is limited to 15 characters on Linux, longer names are truncated.
+    static void set_os_name(const std::string &n) {
+#if defined(__linux__)
+        pthread_setname_np(pthread_self(), n.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+        pthread_setname_np(n.c_str());
+#endif
+    }
+    // setup_ must be locked
+    void apply_name() {
+#if defined(__linux__)
+        pthread_setname_np(native_, name_.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+        // darwin can only rename the calling thread
+        if (pthread_equal(native_, pthread_self()))
+            set_os_name(name_);
+#endif
+    }
+    // setup_ must be locked
+    bool apply_affinity() {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        if (cpus_.empty()) {
+            for (int i = 0; i < CPU_SETSIZE; ++i)
+                CPU_SET(i, &set);
+        }
+        else {
+            for (CpuSet::const_iterator it = cpus_.begin(); it != cpus_.end(); ++it)
+                if (*it >= 0 && *it < CPU_SETSIZE)
+                    CPU_SET(*it, &set);
+        }
+        return pthread_setaffinity_np(native_, sizeof(set), &set) == 0;
+#elif defined(WIN32)
+        DWORD_PTR mask = 0;
+
+        if (cpus_.empty())
+            mask = ~(DWORD_PTR)0;
+        else
+            for (CpuSet::const_iterator it = cpus_.begin(); it != cpus_.end(); ++it)
+                if (*it >= 0 && *it < (int)(sizeof(mask) * 8))
+                    mask |= (DWORD_PTR)1 << *it;
+
+        return SetThreadAffinityMask(native_, mask) != 0;
+#else
+        return cpus_.empty();
+#endif
+    }
+    // setup_ must be locked
+    bool apply_priority() {
+#if defined(WIN32)
+        static const int prios[] = { THREAD_PRIORITY_IDLE, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+                                     THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_TIME_CRITICAL };
+        return SetThreadPriority(native_, prios[priority_]) != 0;
+#else
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+
+        if (priority_ == ThreadPriorityRealtime) {
+            param.sched_priority = (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)) / 2;
+            return pthread_setschedparam(native_, SCHED_FIFO, &param) == 0;
+        }
+
+        int policy;
+        struct sched_param current;
+
+        if (pthread_getschedparam(native_, &policy, &current) == 0 && policy != SCHED_OTHER &&
+            pthread_setschedparam(native_, SCHED_OTHER, &param) != 0)
+            return false;
+#ifdef __linux__
+        // on linux the nice value is per thread
+        static const int nices[] = { 19, 10, 0, -10 };
+        return setpriority(PRIO_PROCESS, tid_, nices[priority_]) == 0;
+#else
+        return priority_ == ThreadPriorityNormal;
+#endif
+#endif
+    }
     /// DOXYS_ON    
 };
 
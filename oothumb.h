@@ -0,0 +1,339 @@
+#ifndef OOTHUMB_H
+#define OOTHUMB_H
+
+/**
+ * GG
+ * Thumbnails of image files for an IconView, decoded in worker threads.
+ */
+
+#include "ootree.h"
+#include "ooqueue.h"
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+namespace gtk {
+
+/** Shows thumbnails of image files in an IconView, decoding them on a WorkerPool.
+
+ThumbnailLoader packs in the IconView a pixbuf renderer of fixed size showing the thumbnail of the file named by a string column of the model. The images are decoded directly at the thumbnail size (gdk_pixbuf_new_from_file_at_size()) by the workers of a WorkerPool, so a folder of photos never blocks the main loop and never holds the full size images in memory.
+
+Only the items in IconView::VisibleRange() are decoded, in display order, followed by a page of items after and before them. When the view is scrolled the requests still queued for the items no longer on screen are dropped, the decodes already running complete and go in the cache. The scaled pixbufs are kept in a cache bounded by memory, when it's full the least recently shown ones are released.
+
+Items whose thumbnail is not ready show the placeholder pixbuf, the renderer has a fixed size so the layout of the view doesn't change when the thumbnails arrive.
+
+\example
+gtk::ListStore files(make_vector(G_TYPE_STRING)(G_TYPE_STRING));
+gtk::IconView icons(files);
+icons.TextColumn(1);
+gtk::WorkerPool pool;
+gtk::ThumbnailLoader thumbs(icons, 0, pool, 96);
+\endexample
+
+\note The view must not have a PixbufColumn() set, the loader renderer takes its place. The WorkerPool must outlive the loader, the tasks still running when the loader is destroyed complete without touching it.
+*/
+class ThumbnailLoader
+{
+/// DOXYS_OFF
+        struct Result {
+            std::string file;
+            GdkPixbuf *pixbuf;
+        };
+        // the state shared with the workers, it outlives the loader while a decode is running
+        struct Shared {
+            Mutex lock;
+            // NULL once the loader is destroyed
+            ThumbnailLoader *owner;
+            int size;
+            // the files to decode, the most urgent at the back
+            std::vector<std::string> wanted;
+            std::unordered_set<std::string> running;
+            std::vector<Result> done;
+            int workers;
+            guint idle;
+
+            Shared(ThumbnailLoader *o, int s) : owner(o), size(s), workers(0), idle(0) {}
+
+            // a worker task, decodes the wanted files until there are no more
+            void pump(std::shared_ptr<Shared> self) {
+                for (;;) {
+                    std::string file;
+                    {
+                        AutoMutex m(lock);
+                        if (!owner || wanted.empty()) {
+                            --workers;
+                            return;
+                        }
+                        file.swap(wanted.back());
+                        wanted.pop_back();
+                        running.insert(file);
+                    }
+                    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file_at_size(file.c_str(), size, size, NULL);
+
+                    AutoMutex m(lock);
+                    running.erase(file);
+                    if (!owner) {
+                        if (pixbuf)
+                            g_object_unref(pixbuf);
+                        continue;
+                    }
+                    Result r = { file, pixbuf };
+                    done.push_back(r);
+                    if (!idle)
+                        idle = g_idle_add_full(G_PRIORITY_HIGH_IDLE, GSourceFunc(arrived), this, NULL);
+                }
+            }
+            // the idle is removed by the loader destructor, so owner is valid here
+            static gboolean arrived(gpointer p) {
+                Shared *s = static_cast<Shared *>(p);
+                std::vector<Result> results;
+                {
+                    AutoMutex m(s->lock);
+                    results.swap(s->done);
+                    s->idle = 0;
+                }
+                s->owner->arrived(results);
+                return FALSE;
+            }
+        };
+        struct Entry {
+            std::string file;
+            GdkPixbuf *pixbuf;
+            size_t bytes;
+        };
+        typedef std::list<Entry> Lru;
+
+        GtkIconView *view_;
+        GtkCellRenderer *renderer_;
+        int column_, size_;
+        WorkerPool &pool_;
+        GdkPixbuf *placeholder_;
+        // most recently shown first
+        Lru lru_;
+        std::unordered_map<std::string, Lru::iterator> cache_;
+        std::unordered_set<std::string> failed_;
+        size_t limit_, bytes_;
+        std::shared_ptr<Shared> shared_;
+        gulong expose_;
+        guint update_;
+        bool bound_;
+        // what the last update() has seen, an expose with the same range doesn't request anything
+        GtkTreeModel *model_;
+        int rows_, first_, last_;
+
+        static void cell_data(GtkCellLayout *, GtkCellRenderer *cell, GtkTreeModel *model, GtkTreeIter *iter, gpointer p) {
+            ThumbnailLoader *l = static_cast<ThumbnailLoader *>(p);
+            gchar *file = NULL;
+            gtk_tree_model_get(model, iter, l->column_, &file, -1);
+            GdkPixbuf *pixbuf = l->placeholder_;
+            if (file) {
+                // the layout reads every item, the LRU order is only updated for the visible ones
+                std::unordered_map<std::string, Lru::iterator>::iterator c = l->cache_.find(file);
+                if (c != l->cache_.end())
+                    pixbuf = c->second->pixbuf;
+                g_free(file);
+            }
+            g_object_set(cell, "pixbuf", pixbuf, NULL);
+        }
+        static void unbound(gpointer p) { static_cast<ThumbnailLoader *>(p)->bound_ = false; }
+        static gboolean exposed(GtkWidget *, GdkEventExpose *, ThumbnailLoader *l) {
+            if (!l->update_)
+                l->update_ = g_idle_add(GSourceFunc(idle_update), l);
+            return FALSE;
+        }
+        static gboolean idle_update(ThumbnailLoader *l) {
+            l->update_ = 0;
+            l->update(false);
+            return FALSE;
+        }
+
+        // appends the files of the rows from, to (included) to files, skipping the ones already decoded
+        void collect(GtkTreeModel *model, int from, int to, std::vector<std::string> &files, bool touch) {
+            GtkTreeIter it;
+            if (from > to || !gtk_tree_model_iter_nth_child(model, &it, NULL, from))
+                return;
+            for (int r = from; r <= to; ++r) {
+                gchar *file = NULL;
+                gtk_tree_model_get(model, &it, column_, &file, -1);
+                if (file) {
+                    std::unordered_map<std::string, Lru::iterator>::iterator c = cache_.find(file);
+                    if (c != cache_.end()) {
+                        if (touch)
+                            lru_.splice(lru_.begin(), lru_, c->second);
+                    }
+                    else if (!failed_.count(file))
+                        files.push_back(file);
+                    g_free(file);
+                }
+                if (!gtk_tree_model_iter_next(model, &it))
+                    break;
+            }
+        }
+        void update(bool force) {
+            GtkTreeModel *model = gtk_icon_view_get_model(view_);
+            GtkTreePath *start, *end;
+            if (!model || !gtk_icon_view_get_visible_range(view_, &start, &end))
+                return;
+            int first = gtk_tree_path_get_indices(start)[0], last = gtk_tree_path_get_indices(end)[0];
+            gtk_tree_path_free(start);
+            gtk_tree_path_free(end);
+            int rows = gtk_tree_model_iter_n_children(model, NULL);
+            if (!force && model == model_ && rows == rows_ && first == first_ && last == last_)
+                return;
+            model_ = model;
+            rows_ = rows;
+            first_ = first;
+            last_ = last;
+
+            // visible items first, then the next page and the previous one, nearest first
+            int page = last - first + 1;
+            std::vector<std::string> files, before;
+            collect(model, first, last, files, true);
+            collect(model, last + 1, std::min(rows - 1, last + page), files, false);
+            collect(model, std::max(0, first - page), first - 1, before, false);
+            files.insert(files.end(), before.rbegin(), before.rend());
+            std::reverse(files.begin(), files.end());
+
+            int start_workers;
+            {
+                AutoMutex m(shared_->lock);
+                shared_->wanted.clear();
+                for (size_t i = 0; i < files.size(); ++i)
+                    if (!shared_->running.count(files[i]))
+                        shared_->wanted.push_back(files[i]);
+                int max = std::min((int)shared_->wanted.size(), pool_.Threads());
+                start_workers = std::max(0, max - shared_->workers);
+                shared_->workers += start_workers;
+            }
+            for (int i = 0; i < start_workers; ++i)
+                if (!pool_.Post(&Shared::pump, shared_.get(), shared_)) {
+                    AutoMutex m(shared_->lock);
+                    shared_->workers -= start_workers - i;
+                    break;
+                }
+        }
+        void arrived(const std::vector<Result> &results) {
+            for (size_t i = 0; i < results.size(); ++i) {
+                const Result &r = results[i];
+                if (!r.pixbuf) {
+                    failed_.insert(r.file);
+                    continue;
+                }
+                // the file may have been decoded twice if it was forgotten while running
+                std::unordered_map<std::string, Lru::iterator>::iterator c = cache_.find(r.file);
+                if (c != cache_.end())
+                    drop(c->second);
+                Entry e = { r.file, r.pixbuf, (size_t)gdk_pixbuf_get_rowstride(r.pixbuf) * gdk_pixbuf_get_height(r.pixbuf) };
+                lru_.push_front(e);
+                cache_[r.file] = lru_.begin();
+                bytes_ += e.bytes;
+            }
+            // the most recent thumbnail stays even if it's bigger than the limit
+            while (bytes_ > limit_ && lru_.size() > 1)
+                drop(--lru_.end());
+            // the renderer has a fixed size, a redraw is enough and no row needs a new layout
+            gtk_widget_queue_draw(GTK_WIDGET(view_));
+        }
+        void drop(Lru::iterator e) {
+            bytes_ -= e->bytes;
+            g_object_unref(e->pixbuf);
+            cache_.erase(e->file);
+            lru_.erase(e);
+        }
+
+        ThumbnailLoader(const ThumbnailLoader &);
+        ThumbnailLoader &operator=(const ThumbnailLoader &);
+/// DOXYS_ON
+    public:
+        /** Packs the thumbnail renderer in view and starts decoding the visible items.
+
+The file names are read from column, a G_TYPE_STRING column of the model of the view; the model can be set or replaced later with IconView::Model(), only the top level rows are shown.
+        */
+        ThumbnailLoader(GtkIconView *view /**< the view showing the thumbnails */,
+                        int column /**< a G_TYPE_STRING column holding the file names */,
+                        WorkerPool &pool /**< the pool decoding the images */,
+                        int size = 128 /**< the width and height of the thumbnails */,
+                        size_t cache_bytes = 64 * 1024 * 1024 /**< the memory used by the cached thumbnails */,
+                        GdkPixbuf *placeholder = NULL /**< shown while the thumbnail is decoded or if the file isn't an image */) :
+            view_(view), column_(column), size_(size), pool_(pool), placeholder_(placeholder),
+            limit_(cache_bytes), bytes_(0), shared_(new Shared(this, size)), update_(0), bound_(true),
+            model_(NULL), rows_(-1), first_(-1), last_(-1) {
+            g_object_ref(view_);
+            if (placeholder_)
+                g_object_ref(placeholder_);
+
+            renderer_ = gtk_cell_renderer_pixbuf_new();
+            gtk_cell_renderer_set_fixed_size(renderer_, size, size);
+            gtk_cell_layout_pack_start(GTK_CELL_LAYOUT(view_), renderer_, FALSE);
+            g_object_ref(renderer_);
+            gtk_cell_layout_set_cell_data_func(GTK_CELL_LAYOUT(view_), renderer_, cell_data, this, unbound);
+            expose_ = g_signal_connect_after(view_, "expose-event", GCallback(exposed), this);
+        }
+        /// Stops the pending decodes and releases the cached thumbnails.
+        ~ThumbnailLoader() {
+            {
+                AutoMutex m(shared_->lock);
+                shared_->owner = NULL;
+                shared_->wanted.clear();
+                if (shared_->idle)
+                    g_source_remove(shared_->idle);
+                for (size_t i = 0; i < shared_->done.size(); ++i)
+                    if (shared_->done[i].pixbuf)
+                        g_object_unref(shared_->done[i].pixbuf);
+                shared_->done.clear();
+            }
+            if (update_)
+                g_source_remove(update_);
+            g_signal_handler_disconnect(view_, expose_);
+            // the view clears its cells when destroyed
+            if (bound_) {
+                gtk_cell_layout_set_cell_data_func(GTK_CELL_LAYOUT(view_), renderer_, NULL, NULL, NULL);
+                g_object_set(renderer_, "pixbuf", placeholder_, NULL);
+            }
+            g_object_unref(renderer_);
+            Clear();
+            if (placeholder_)
+                g_object_unref(placeholder_);
+            g_object_unref(view_);
+        }
+
+        /** Requests the thumbnails of the visible items.
+
+It's called automatically when the view is drawn with a different visible range or a different number of rows, call it after the files of some rows have been changed in place.
+        */
+        void Update() { update(true); }
+        /// Releases every cached thumbnail, they are decoded again when shown.
+        void Clear() {
+            while (!lru_.empty())
+                drop(lru_.begin());
+            failed_.clear();
+            first_ = last_ = -1;
+            gtk_widget_queue_draw(GTK_WIDGET(view_));
+        }
+        /// Releases the thumbnail of a file that has been modified, it's decoded again if shown.
+        void Forget(const std::string &file) {
+            std::unordered_map<std::string, Lru::iterator>::iterator c = cache_.find(file);
+            if (c != cache_.end())
+                drop(c->second);
+            failed_.erase(file);
+            first_ = last_ = -1;
+            gtk_widget_queue_draw(GTK_WIDGET(view_));
+        }
+        /// Returns the number of thumbnails in the cache.
+        size_t Cached() const { return lru_.size(); }
+        /// Returns the memory used by the cached thumbnails.
+        size_t CacheBytes() const { return bytes_; }
+        /// Returns the number of files waiting for a worker.
+        size_t Pending() const {
+            AutoMutex m(shared_->lock);
+            return shared_->wanted.size();
+        }
+        /// Returns the width and height of the thumbnails.
+        int Size() const { return size_; }
+};
+
+}
+#endif
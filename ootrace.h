@@ -0,0 +1,407 @@
+#ifndef OOTRACE_H
+#define OOTRACE_H
+
+/**
+ * GG
+ * Low overhead tracing: every thread writes binary records in its own
+ * ring buffer, a flusher thread formats them and sends them to the sink.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+#include "oomutex.h"
+
+namespace gtk {
+
+/// Severity of a trace record, see OOGTK_TRACE.
+enum TraceLevel {
+    TraceError = 1 /**< something failed */,
+    TraceWarning /**< something unexpected that the library can handle */,
+    TraceInfo /**< notable events */,
+    TraceDebug /**< object lifecycle and other verbose informations */
+};
+
+}
+
+/** Highest TraceLevel compiled in the library.
+
+Trace calls above this level are removed at compile time, including the evaluation of their arguments. It defaults to TraceDebug if OOGTK_DEBUG is defined and to TraceWarning otherwise, it can be redefined before including oogtk.h:
+
+\example
+#define OOGTK_TRACE_LEVEL 3 // gtk::TraceInfo
+#include "oogtk.h"
+\endexample
+*/
+#ifndef OOGTK_TRACE_LEVEL
+#ifdef OOGTK_DEBUG
+#define OOGTK_TRACE_LEVEL 4
+#else
+#define OOGTK_TRACE_LEVEL 2
+#endif
+#endif
+
+/** Writes a trace record.
+
+The first parameter is a TraceLevel, the second a printf like format string that must be a string literal, since only its address is stored in the record, the others are the values referenced by the format. Integers, floating point values and pointers are stored in binary form, strings (const char * or std::string) are copied in the record, and truncated if they don't fit.
+
+\example
+OOGTK_TRACE(gtk::TraceInfo, "loaded %d rows from %s in %.2fms", rows, filename, elapsed);
+\endexample
+*/
+#define OOGTK_TRACE(level, ...) \
+    do { if ((level) <= OOGTK_TRACE_LEVEL) gtk::Trace::Write((level), __VA_ARGS__); } while (0)
+
+namespace gtk {
+
+/** The oogtk tracing facility.
+
+Trace records are written with the OOGTK_TRACE macro, writing a record doesn't take locks and doesn't format anything: the values are stored in a fixed size record inside a ring buffer owned by the calling thread. A flusher thread, started with the first record, collects the records of all the threads every 100ms (or sooner if a buffer is half full), formats them and passes them to the sink, that writes them to stderr by default.
+
+If a thread writes records faster than the flusher can collect them the new records are dropped and the number of lost records is reported in the trace.
+
+Every line of the trace contains the time in seconds from the first record, the thread id (and name, for the threads started by gtk::Thread), the level and the message:
+
+\example
+    0.001352 [T2 loader] E thread loader refused to die - and cancelling not implemented!
+\endexample
+*/
+class Trace
+{
+    public:
+        /// The function that receives the formatted lines, line is NUL terminated and includes the final newline.
+        typedef void (*Sink)(const char *line, size_t length);
+
+        enum {
+            RingSize = 512 /**< records in every per thread buffer */,
+            FlushInterval = 100 /**< maximum delay, in milliseconds, between a record and its output */
+        };
+
+/// DOXYS_OFF
+        // stores the arguments of a trace call in a record
+        struct Record {
+            enum { MaxArgs = 8, TextSize = 56 };
+            enum Tag { Int, Uint, Double, Pointer, String };
+
+            gint64 time;
+            const char *fmt;
+            unsigned char level, nargs, tags[MaxArgs];
+            union {
+                gint64 i;
+                guint64 u;
+                double d;
+                const void *p;
+                size_t s; // offset in text
+            } args[MaxArgs];
+            char text[TextSize];
+            size_t used;
+
+            template <typename T>
+            typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type put(T v) {
+                if (nargs == MaxArgs)
+                    return;
+                if (std::is_signed<T>::value || std::is_enum<T>::value) {
+                    tags[nargs] = Int;
+                    args[nargs++].i = (gint64)v;
+                }
+                else {
+                    tags[nargs] = Uint;
+                    args[nargs++].u = (guint64)v;
+                }
+            }
+            void put(double v) {
+                if (nargs == MaxArgs)
+                    return;
+                tags[nargs] = Double;
+                args[nargs++].d = v;
+            }
+            void put(float v) { put((double)v); }
+            template <typename T>
+            void put(T *v) {
+                if (nargs == MaxArgs)
+                    return;
+                tags[nargs] = Pointer;
+                args[nargs++].p = (const void *)v;
+            }
+            void put(const char *v, size_t len) {
+                if (nargs == MaxArgs)
+                    return;
+                size_t room = TextSize - used - 1;
+                if (len > room)
+                    len = room;
+                memcpy(text + used, v, len);
+                text[used + len] = 0;
+                tags[nargs] = String;
+                args[nargs++].s = used;
+                used += len + 1;
+                if (used >= TextSize)
+                    used = TextSize - 1;
+            }
+            void put(const char *v) { if (v) put(v, strlen(v)); else put("(null)", 6); }
+            void put(char *v) { put((const char *)v); }
+            void put(const std::string &v) { put(v.c_str(), v.length()); }
+
+            void store() {}
+            template <typename T, typename... Args>
+            void store(const T &v, const Args &... args) {
+                put(v);
+                store(args...);
+            }
+        };
+
+        struct Ring {
+            Record records_[RingSize];
+            std::atomic<unsigned> head_, tail_, dropped_;
+            std::atomic<bool> orphan_;
+            unsigned id_;
+            char name_[16];
+
+            Ring(unsigned id) : head_(0), tail_(0), dropped_(0), orphan_(false), id_(id) { name_[0] = 0; }
+        };
+/// DOXYS_ON
+
+        /// Writes a record, use the OOGTK_TRACE macro to filter it at compile time.
+        template <typename... Args>
+        static void Write(int level, const char *fmt, const Args &... args) {
+            Ring *r = ring();
+            if (!r)
+                return;
+
+            unsigned h = r->head_.load(std::memory_order_relaxed);
+            unsigned t = r->tail_.load(std::memory_order_acquire);
+
+            if (h - t >= RingSize) {
+                r->dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Record &rec = r->records_[h % RingSize];
+            rec.time = g_get_monotonic_time();
+            rec.fmt = fmt;
+            rec.level = (unsigned char)level;
+            rec.nargs = 0;
+            rec.used = 0;
+            rec.store(args...);
+
+            r->head_.store(h + 1, std::memory_order_release);
+
+            // wake up the flusher before the buffer fills up
+            if (h - t == RingSize / 2)
+                wakeup();
+        }
+        /// Sets the name shown in the trace lines written by the calling thread.
+        static void ThreadName(const std::string &name) {
+            char *n = local_name();
+            strncpy(n, name.c_str(), sizeof(Ring::name_) - 1);
+            n[sizeof(Ring::name_) - 1] = 0;
+
+            if (Ring *r = local()) {
+                AutoMutex lock(global().lock_);
+                memcpy(r->name_, n, sizeof(r->name_));
+            }
+        }
+        /// Replaces the sink of the formatted lines, NULL restores the default one (stderr). The sink is called by a single thread at a time.
+        static void SetSink(Sink sink) {
+            AutoMutex lock(global().drain_);
+            global().sink_ = sink ? sink : stderr_sink;
+        }
+        /// Formats and outputs all the pending records, in the calling thread.
+        static void Flush() { drain(); }
+
+/// DOXYS_OFF
+    private:
+        struct Global {
+            Mutex lock_;   // protects rings_
+            Mutex drain_;  // serializes the consumers
+            Sync wakeup_;
+            std::vector<Ring *> rings_;
+            unsigned next_id_;
+            gint64 start_;
+            Sink sink_;
+            bool pending_;
+            Global() : next_id_(1), start_(g_get_monotonic_time()), sink_(stderr_sink), pending_(false) {}
+        };
+        // marks the ring of a terminating thread, the flusher will release it once empty
+        struct RingGuard {
+            ~RingGuard() {
+                Ring *&r = local();
+                if (r) {
+                    r->orphan_.store(true, std::memory_order_release);
+                    r = NULL;
+                }
+                dead() = true;
+            }
+        };
+
+        static Global &global() {
+            // never destroyed, threads can trace after the static destructors ran
+            static Global *g = new Global();
+            return *g;
+        }
+        static Ring *&local() { static thread_local Ring *r = NULL; return r; }
+        static bool &dead() { static thread_local bool d = false; return d; }
+        static char *local_name() { static thread_local char n[sizeof(Ring::name_)]; return n; }
+
+        static Ring *ring() {
+            Ring *&r = local();
+            if (!r && !dead()) {
+                static thread_local RingGuard guard;
+                (void)guard;
+
+                Global &g = global();
+                {
+                    AutoMutex lock(g.lock_);
+                    r = new Ring(g.next_id_++);
+                    memcpy(r->name_, local_name(), sizeof(r->name_));
+                    g.rings_.push_back(r);
+                }
+                if (r->id_ == 1)
+                    start_flusher();
+            }
+            return r;
+        }
+        static void wakeup() {
+            Global &g = global();
+            g.wakeup_.Lock();
+            g.pending_ = true;
+            g.wakeup_.Signal();
+            g.wakeup_.Unlock();
+        }
+        static void stderr_sink(const char *line, size_t length) {
+            fwrite(line, 1, length, stderr);
+        }
+        static gpointer flusher(gpointer) {
+            Global &g = global();
+            for (;;) {
+                g.wakeup_.Lock();
+                if (!g.pending_)
+                    g.wakeup_.Wait(FlushInterval);
+                g.pending_ = false;
+                g.wakeup_.Unlock();
+
+                drain();
+            }
+            return NULL;
+        }
+        static void start_flusher() {
+            atexit(drain);
+#if GLIB_MINOR_VERSION < 32
+            g_thread_create(flusher, NULL, FALSE, NULL);
+#else
+            g_thread_unref(g_thread_new("oogtk trace", flusher, NULL));
+#endif
+        }
+        static void drain() {
+            Global &g = global();
+            AutoMutex drain_lock(g.drain_);
+            std::vector<Ring *> rings;
+            {
+                AutoMutex lock(g.lock_);
+                rings = g.rings_;
+            }
+            std::string line;
+
+            for (size_t i = 0; i < rings.size(); ++i) {
+                Ring *r = rings[i];
+                bool orphan = r->orphan_.load(std::memory_order_acquire);
+                unsigned t = r->tail_.load(std::memory_order_relaxed);
+                unsigned h = r->head_.load(std::memory_order_acquire);
+                char name[sizeof(r->name_)];
+                {
+                    AutoMutex lock(g.lock_);
+                    memcpy(name, r->name_, sizeof(name));
+                }
+
+                for (; t != h; ++t) {
+                    format(line, r->records_[t % RingSize], r->id_, name, g.start_);
+                    g.sink_(line.c_str(), line.length());
+                }
+                r->tail_.store(t, std::memory_order_release);
+
+                if (unsigned lost = r->dropped_.exchange(0, std::memory_order_relaxed)) {
+                    char buf[96];
+                    int n = g_snprintf(buf, sizeof(buf), "%12.6f [T%u%s%s] W %u trace records dropped\n",
+                                       (g_get_monotonic_time() - g.start_) / 1e6, r->id_, name[0] ? " " : "", name, lost);
+                    g.sink_(buf, n);
+                }
+                if (orphan) {
+                    // the thread is gone, no more writes after the orphan flag
+                    AutoMutex lock(g.lock_);
+                    for (std::vector<Ring *>::iterator it = g.rings_.begin(); it != g.rings_.end(); ++it)
+                        if (*it == r) {
+                            g.rings_.erase(it);
+                            break;
+                        }
+                    delete r;
+                }
+            }
+        }
+        static void format(std::string &line, const Record &rec, unsigned id, const char *name, gint64 start) {
+            static const char levels[] = "?EWID";
+            char buf[128];
+
+            g_snprintf(buf, sizeof(buf), "%12.6f [T%u%s%s] %c ", (rec.time - start) / 1e6, id,
+                       name[0] ? " " : "", name, levels[rec.level < 5 ? rec.level : 0]);
+            line = buf;
+
+            unsigned arg = 0;
+            for (const char *p = rec.fmt; *p; ++p) {
+                if (*p != '%') {
+                    line += *p;
+                    continue;
+                }
+                if (p[1] == '%') {
+                    line += '%';
+                    ++p;
+                    continue;
+                }
+                // flags, width and precision are kept, length modifiers are replaced
+                const char *begin = p++;
+                while (*p && strchr("-+ #0123456789.", *p))
+                    ++p;
+                std::string spec(begin, p - begin);
+                while (*p && strchr("hlLqjzt", *p))
+                    ++p;
+                if (!*p)
+                    break;
+
+                char conv = *p;
+                if (arg >= rec.nargs) {
+                    line.append(begin, p - begin + 1);
+                    continue;
+                }
+                switch (rec.tags[arg]) {
+                    case Record::Int:
+                        if (conv == 'c')
+                            g_snprintf(buf, sizeof(buf), (spec + 'c').c_str(), (int)rec.args[arg].i);
+                        else
+                            g_snprintf(buf, sizeof(buf), (spec + G_GINT64_MODIFIER + (strchr("diouxX", conv) ? conv : 'd')).c_str(), rec.args[arg].i);
+                        break;
+                    case Record::Uint:
+                        g_snprintf(buf, sizeof(buf), (spec + G_GINT64_MODIFIER + (strchr("ouxX", conv) ? conv : 'u')).c_str(), rec.args[arg].u);
+                        break;
+                    case Record::Double:
+                        g_snprintf(buf, sizeof(buf), (spec + (strchr("eEfFgG", conv) ? conv : 'g')).c_str(), rec.args[arg].d);
+                        break;
+                    case Record::Pointer:
+                        g_snprintf(buf, sizeof(buf), "%p", rec.args[arg].p);
+                        break;
+                    case Record::String:
+                        g_snprintf(buf, sizeof(buf), (spec + 's').c_str(), rec.text + rec.args[arg].s);
+                        break;
+                }
+                line += buf;
+                ++arg;
+            }
+            line += '\n';
+        }
+/// DOXYS_ON
+};
+
+}
+
+#endif
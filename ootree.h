@@ -4,7 +4,14 @@
 #include "oogtk.h"
 #include <vector>
 #include <list>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <stdarg.h>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 namespace gtk {
     /**
@@ -28,6 +35,12 @@ namespace gtk {
         CellRendererModeEditable = GTK_CELL_RENDERER_MODE_EDITABLE /**< The cell can be edited or otherwise modified.  */
     };
 
+    /// How the text columns added by TreeView and ComboBox bind the strings of the model.
+    enum TextMode {
+        TextMarkup /**< The strings are Pango markup, bound to the "markup" property and parsed every time a cell is drawn. */,
+        TextPlain /**< The strings are plain text, bound to the "text" property, no markup is parsed. Use TreeViewColumn::TextAttributes() to style the whole column. */
+    };
+
     /// Used to control what selections users are allowed to make. 
     enum SelectionMode {
         SelectionNone = GTK_SELECTION_NONE /**< No selection is possible. */,
@@ -37,60 +50,227 @@ namespace gtk {
         SelectionExtended = GTK_SELECTION_EXTENDED /**< Deprecated, now falls back and behave exactly like SelectionMultiple */
     };
 
+/** A path to a row of a TreeModel.
+
+The indices of the path are stored in the object, up to TreePath::Inline levels without any allocation, the GtkTreePath needed by GTK is built only when the path is passed to a GTK function and then reused. Paths can be moved, a TreePath built from a GtkTreePath returned by GTK takes ownership of it without copying it.
+
+\example
+gtk::TreePath path("2");    // the third row
+path.Append(4);             // its fifth child, "2:4"
+for (gtk::TreePath p("0"); p[0] < 1000; ++p)
+    selection.Select(p);    // no allocation per row
+\endexample
+*/
     class TreePath // complete API 
     {
          public:
-            operator  GtkTreePath *() const { return obj_; }
-            TreePath(const TreePath &o) { obj_ = gtk_tree_path_copy(o); }
-            TreePath(GtkTreePath *o) { obj_ = o; }
-
-            TreePath(const std::string &path = "") {
-                if (!path.empty())
-                    obj_ = gtk_tree_path_new_from_string(path.c_str());
-                else
-                    obj_ = gtk_tree_path_new();
+            /// The number of indices stored without allocations.
+            enum { Inline = 8 };
+/// DOXYS_OFF
+            operator  GtkTreePath *() const { return native(); }
+/// DOXYS_ON
+            /// Creates a path of depth 0.
+            TreePath() { init(); }
+            TreePath(const TreePath &o) {
+                init();
+                o.sync();
+                assign(o.indices(), o.depth_);
+            }
+            TreePath(TreePath &&o) {
+                init();
+                swap(o);
+            }
+            /// Takes ownership of a GtkTreePath, that is freed by the TreePath.
+            TreePath(GtkTreePath *o) {
+                init();
+                obj_ = o;
+                native_ = (o != NULL);
+            }
+            /// Creates a path from a string like "0:0:1".
+            TreePath(const std::string &path) {
+                init();
+                const char *s = path.c_str();
+                while (*s) {
+                    char *end;
+                    long idx = strtol(s, &end, 10);
+                    if (end == s || idx < 0) {
+                        depth_ = 0;
+                        break;
+                    }
+                    Append(idx);
+                    s = *end == ':' ? end + 1 : end;
+                }
+            }
+            ~TreePath() {
+                if (obj_)
+                    gtk_tree_path_free(obj_);
+                delete [] heap_;
             }
-            ~TreePath() { gtk_tree_path_free(obj_); }
 
             TreePath &operator=(const TreePath &orig) {
-                gtk_tree_path_free(obj_);
-                obj_ = gtk_tree_path_copy(orig);
+                if (&orig != this) {
+                    orig.sync();
+                    native_ = false;
+                    assign(orig.indices(), orig.depth_);
+                }
+                return *this;
+            }
+            TreePath &operator=(TreePath &&orig) {
+                swap(orig);
                 return *this;
             }
             TreePath &operator=(const GtkTreePath &orig) {
-                gtk_tree_path_free(obj_);
-                obj_ = gtk_tree_path_copy(&orig);
+                GtkTreePath *p = const_cast<GtkTreePath *>(&orig);
+                native_ = false;
+                assign(gtk_tree_path_get_indices(p), gtk_tree_path_get_depth(p));
                 return *this;
             }
+            /// Swaps the content of two paths.
+            void swap(TreePath &o) {
+                sync();
+                o.sync();
+                std::swap(inline_, o.inline_);
+                std::swap(heap_, o.heap_);
+                std::swap(capacity_, o.capacity_);
+                std::swap(depth_, o.depth_);
+                std::swap(obj_, o.obj_);
+            }
             std::string str() const {
+                sync();
                 std::string ret;
-                if (gchar *c = gtk_tree_path_to_string (*this)) {
-                    ret = c;
-                    g_free(c);
+                char buf[16];
+                for (int i = 0; i < depth_; ++i) {
+                    g_snprintf(buf, sizeof(buf), i ? ":%d" : "%d", indices()[i]);
+                    ret += buf;
                 }
                 return ret;
             }
             std::string ToString() const { return str(); }
-            void Append(int idx) { gtk_tree_path_append_index(*this, idx); }
-            void Prepend(int idx) { gtk_tree_path_prepend_index(*this, idx); }
-
-            int Depth() const { return gtk_tree_path_get_depth(*this); }
-            bool operator==(const TreePath &p) { return gtk_tree_path_compare(*this, p) == 0; }
-            bool operator!=(const TreePath &p) { return gtk_tree_path_compare(*this, p) != 0; }
-
-            TreePath &operator++() { gtk_tree_path_next(*this); return *this; }
-            TreePath &operator--() { gtk_tree_path_prev(*this); return *this; }
+            void Append(int idx) {
+                sync();
+                reserve(depth_ + 1);
+                indices()[depth_++] = idx;
+            }
+            void Prepend(int idx) {
+                sync();
+                reserve(depth_ + 1);
+                int *i = indices();
+                memmove(i + 1, i, depth_ * sizeof(int));
+                i[0] = idx;
+                ++depth_;
+            }
+
+            int Depth() const { sync(); return depth_; }
+            /// Returns the index at level, level must be lower than Depth().
+            int operator[](int level) const { sync(); return indices()[level]; }
+            /// Returns the indices of the path, Depth() values valid until the path is modified.
+            const int *Indices() const { sync(); return indices(); }
+            bool operator==(const TreePath &p) const { return compare(p) == 0; }
+            bool operator!=(const TreePath &p) const { return compare(p) != 0; }
+            /// Orders the paths like gtk_tree_path_compare(), a parent comes before its children.
+            bool operator<(const TreePath &p) const { return compare(p) < 0; }
+
+            TreePath &operator++() { Next(); return *this; }
+            TreePath &operator--() { Pred(); return *this; }
 
             // to emulate GTK api we offer also Next/Pred
-            void Next() { gtk_tree_path_next(*this); }
-            void Pred() { gtk_tree_path_prev(*this); }
-            void Up() { gtk_tree_path_up(*this); }
-            void Down() { gtk_tree_path_down(*this); }
+            void Next() {
+                sync();
+                if (depth_)
+                    ++indices()[depth_ - 1];
+            }
+            void Pred() {
+                sync();
+                if (depth_ && indices()[depth_ - 1] > 0)
+                    --indices()[depth_ - 1];
+            }
+            void Up() {
+                sync();
+                if (depth_)
+                    --depth_;
+            }
+            void Down() { Append(0); }
 
-            bool IsAncestor(const TreePath &descendant) const { return gtk_tree_path_is_ancestor(*this, descendant); }
-            bool IsDescendant(const TreePath &ancestor) const { return gtk_tree_path_is_descendant(*this, ancestor); }
+            bool IsAncestor(const TreePath &descendant) const { return descendant.starts_with(*this); }
+            bool IsDescendant(const TreePath &ancestor) const { return starts_with(ancestor); }
+/// DOXYS_OFF
         private:
-            GtkTreePath *obj_;
+            int inline_[Inline];
+            int *heap_;
+            int capacity_;
+            int depth_;
+            // the GtkTreePath given to GTK, when native_ is set it's the current value of the path
+            mutable GtkTreePath *obj_;
+            mutable bool native_;
+
+            void init() {
+                heap_ = NULL;
+                capacity_ = Inline;
+                depth_ = 0;
+                obj_ = NULL;
+                native_ = false;
+            }
+            int *indices() { return heap_ ? heap_ : inline_; }
+            const int *indices() const { return heap_ ? heap_ : inline_; }
+            void reserve(int depth) {
+                if (depth <= capacity_)
+                    return;
+                int capacity = capacity_ * 2 > depth ? capacity_ * 2 : depth;
+                int *h = new int[capacity];
+                memcpy(h, indices(), depth_ * sizeof(int));
+                delete [] heap_;
+                heap_ = h;
+                capacity_ = capacity;
+            }
+            void assign(const int *idx, int depth) {
+                reserve(depth);
+                // idx may point to our own indices, and is NULL for an empty GtkTreePath
+                if (depth)
+                    memmove(indices(), idx, depth * sizeof(int));
+                depth_ = depth;
+            }
+            // copies back the GtkTreePath, GTK may have changed it
+            void sync() const {
+                if (!native_)
+                    return;
+                TreePath *self = const_cast<TreePath *>(this);
+                self->native_ = false;
+                self->assign(gtk_tree_path_get_indices(obj_), gtk_tree_path_get_depth(obj_));
+            }
+            // updates the GtkTreePath reusing its storage
+            GtkTreePath *native() const {
+                if (!native_) {
+                    if (!obj_)
+                        obj_ = gtk_tree_path_new();
+                    int d = gtk_tree_path_get_depth(obj_);
+                    for (; d > depth_; --d)
+                        gtk_tree_path_up(obj_);
+                    for (; d < depth_; ++d)
+                        gtk_tree_path_append_index(obj_, 0);
+                    if (depth_)
+                        memcpy(gtk_tree_path_get_indices(obj_), indices(), depth_ * sizeof(int));
+                    native_ = true;
+                }
+                return obj_;
+            }
+            int compare(const TreePath &p) const {
+                sync();
+                p.sync();
+                const int *a = indices(), *b = p.indices();
+                for (int i = 0; i < depth_ && i < p.depth_; ++i)
+                    if (a[i] != b[i])
+                        return a[i] < b[i] ? -1 : 1;
+                return depth_ == p.depth_ ? 0 : (depth_ < p.depth_ ? -1 : 1);
+            }
+            // true if prefix is a proper ancestor of this path
+            bool starts_with(const TreePath &prefix) const {
+                sync();
+                prefix.sync();
+                if (prefix.depth_ >= depth_)
+                    return false;
+                return memcmp(indices(), prefix.indices(), prefix.depth_ * sizeof(int)) == 0;
+            }
+/// DOXYS_ON
     };
 
     class TreeView;
@@ -166,8 +346,135 @@ If the previous type was SelectionMultiple, then the anchor is kept selected, if
             //// Returns a RefVec containing a TreeRowReference for every line in the TreeSelection
             RefVec SelectedRows();
 
+            /** Groups changes to the selection so that "changed" is emitted once.
+
+While a Batch exists, the "changed" handlers of the selection are blocked. When the Batch is destroyed, "changed" is emitted once if the selection changed. Nested batches are merged into the outermost one. Handlers connected while the batch is alive are not blocked.
+
+\example
+{
+    gtk::TreeSelection::Batch batch(selection);
+    for (size_t i = 0; i < paths.size(); ++i)
+        selection.Select(paths[i]);
+}   // a single "changed" here
+\endexample
+            */
+            class Batch
+            {
+/// DOXYS_OFF
+                    GtkTreeSelection *sel_;
+                    std::vector<gulong> blocked_;
+                    gulong counter_;
+                    bool changed_;
+
+                    static void count(GtkTreeSelection *, Batch *b) { b->changed_ = true; }
+                    Batch(const Batch &);
+                    Batch &operator=(const Batch &);
+/// DOXYS_ON
+                public:
+                    Batch(GtkTreeSelection *selection) : sel_(NULL), counter_(0), changed_(false) {
+                        if (g_object_get_data(G_OBJECT(selection), "oogtk-batch"))
+                            return;
+                        sel_ = selection;
+                        g_object_set_data(G_OBJECT(sel_), "oogtk-batch", this);
+                        guint id = g_signal_lookup("changed", GTK_TYPE_TREE_SELECTION);
+                        while (gulong h = g_signal_handler_find(sel_, GSignalMatchType(G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_UNBLOCKED),
+                                                                id, 0, NULL, NULL, NULL)) {
+                            g_signal_handler_block(sel_, h);
+                            blocked_.push_back(h);
+                        }
+                        counter_ = g_signal_connect(sel_, "changed", GCallback(count), this);
+                    }
+                    ~Batch() {
+                        if (!sel_)
+                            return;
+                        g_signal_handler_disconnect(sel_, counter_);
+                        for (size_t i = 0; i < blocked_.size(); ++i)
+                            if (g_signal_handler_is_connected(sel_, blocked_[i]))
+                                g_signal_handler_unblock(sel_, blocked_[i]);
+                        g_object_set_data(G_OBJECT(sel_), "oogtk-batch", NULL);
+                        if (changed_)
+                            g_signal_emit_by_name(sel_, "changed");
+                    }
+            };
+
+            /// Selects the rows first to last inclusive of a list, with a single "changed" signal.
+            void SelectRange(int first, int last) {
+                TreePath b, e;
+                b.Append(first);
+                e.Append(last);
+                gtk_tree_selection_select_range(*this, b, e);
+            }
+            /** Selects the rows of a list with the given indexes, with a single "changed" signal.
+
+The rows are sorted and consecutive rows are selected as a range, so the cost depends on the number of runs instead of the number of rows.
+            */
+            void SelectRows(const std::vector<int> &rows) { change_rows(rows, true); }
+            /// Unselects the rows of a list with the given indexes, with a single "changed" signal.
+            void UnselectRows(const std::vector<int> &rows) { change_rows(rows, false); }
+            /** Fills rows with the sorted indexes of the selected rows of a list.
+
+No TreePath or TreeRowReference is built. Only the rows at the top level of a tree are reported.
+            */
+            void SelectedRows(std::vector<int> &rows) const {
+                rows.clear();
+                gtk_tree_selection_selected_foreach(*this, add_index, &rows);
+            }
+            /// Resizes mask to the number of rows of the list, true marks the selected rows.
+            void SelectedRows(std::vector<bool> &mask) const {
+                GtkTreeModel *model = gtk_tree_view_get_model(gtk_tree_selection_get_tree_view(*this));
+                mask.assign(model ? gtk_tree_model_iter_n_children(model, NULL) : 0, false);
+                gtk_tree_selection_selected_foreach(*this, set_mask, &mask);
+            }
+
             /// Callback to call if the user change the state of the TreeSelection
             BUILD_VOID_EVENT(OnChanged, "changed");
+/// DOXYS_OFF
+        private:
+            static void add_index(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, gpointer data) {
+                if (gtk_tree_path_get_depth(path) == 1)
+                    static_cast<std::vector<int> *>(data)->push_back(gtk_tree_path_get_indices(path)[0]);
+            }
+            static void set_mask(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, gpointer data) {
+                std::vector<bool> &mask = *static_cast<std::vector<bool> *>(data);
+                int row = gtk_tree_path_get_indices(path)[0];
+                if (gtk_tree_path_get_depth(path) == 1 && row < (int)mask.size())
+                    mask[row] = true;
+            }
+            void change_rows(const std::vector<int> &rows, bool select) {
+                std::vector<int> sorted(rows);
+                std::sort(sorted.begin(), sorted.end());
+                sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+                Batch batch(*this);
+                bool ranges = gtk_tree_selection_get_mode(*this) == GTK_SELECTION_MULTIPLE;
+                TreePath b, e;
+                b.Append(0);
+                e.Append(0);
+                for (size_t i = 0; i < sorted.size(); ) {
+                    size_t j = i;
+                    if (ranges)
+                        while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1)
+                            ++j;
+                    b.Up();
+                    b.Append(sorted[i]);
+                    if (j == i) {
+                        if (select)
+                            gtk_tree_selection_select_path(*this, b);
+                        else
+                            gtk_tree_selection_unselect_path(*this, b);
+                    }
+                    else {
+                        e.Up();
+                        e.Append(sorted[j]);
+                        if (select)
+                            gtk_tree_selection_select_range(*this, b, e);
+                        else
+                            gtk_tree_selection_unselect_range(*this, b, e);
+                    }
+                    i = j + 1;
+                }
+            }
+/// DOXYS_ON
     };
 
     /** The tree interface used by TreeView.
@@ -190,6 +497,58 @@ The lifecycle of an iterator can be a little confusing at first. Iterators are e
 
 To help show some common operation of a model, some examples are provided. The first example shows three ways of getting the iter at the location “3:2:5”. While the first method shown is easier, the second is much more common, as you often get paths from callbacks. 
 */
+    /** A string read from a model without copying it in a std::string.
+
+The string is kept in the GValue filled by gtk_tree_model_get_value(): the models that keep their strings in C++ memory, like ColumnarModel, hand out the stored string itself, ListStore and TreeStore a copy that is freed with the StringRef. The string is valid until the StringRef is reused or destroyed and, for the C++ models, as long as the row isn't modified.
+
+\example
+gtk::StringRef name;
+model.GetValue(it, 0, name);
+if (name.Length() && !strcmp(name.Get(), "gtk"))
+    ...
+\endexample
+    */
+    class StringRef
+    {
+/// DOXYS_OFF
+            GValue value_;
+
+            StringRef(const StringRef &);
+            StringRef &operator=(const StringRef &);
+        public:
+            // an unset value for gtk_tree_model_get_value()
+            GValue *Value() {
+                Clear();
+                return &value_;
+            }
+/// DOXYS_ON
+            StringRef() { memset(&value_, 0, sizeof(value_)); }
+            ~StringRef() { Clear(); }
+
+            /// Releases the string.
+            void Clear() {
+                if (G_IS_VALUE(&value_))
+                    g_value_unset(&value_);
+            }
+            /// Returns the string, NULL if the cell is empty or isn't a string.
+            const char *Get() const {
+                return G_VALUE_HOLDS_STRING(&value_) ? g_value_get_string(&value_) : NULL;
+            }
+            /// Returns the length of the string in bytes.
+            size_t Length() const {
+                const char *s = Get();
+                return s ? strlen(s) : 0;
+            }
+#if __cplusplus >= 201703L
+            /// Returns the string as a view, empty if the cell is empty.
+            std::string_view View() const {
+                const char *s = Get();
+                return s ? std::string_view(s) : std::string_view();
+            }
+            operator std::string_view() const { return View(); }
+#endif
+    };
+
     class TreeModel : public Object
     {
         public:
@@ -208,16 +567,17 @@ To help show some common operation of a model, some examples are provided. The f
                         const_cast<TreeIter *>(&it), idx, &value, -1);
             }
             void GetValue(const TreeIter &it, int idx, std::string &value) {
-                gchar *field;
-                gtk_tree_model_get(*this, 
-                        const_cast<TreeIter *>(&it), idx, &field, -1);
-                if (field) {
-                    value = field;
-                    g_free(field);
-                }
+                StringRef field;
+                GetValue(it, idx, field);
+                if (const char *s = field.Get())
+                    value.assign(s);
                 else
                     value.clear();
             }
+            /// Reads a string without building a std::string, see StringRef.
+            void GetValue(const TreeIter &it, int idx, StringRef &value) {
+                gtk_tree_model_get_value(*this, const_cast<TreeIter *>(&it), idx, value.Value());
+            }
             void GetValue(const TreeIter &it, int idx, long long &value) {
                 gtk_tree_model_get(*this, 
                         const_cast<TreeIter *>(&it), idx, &value, -1);
@@ -261,6 +621,78 @@ Otherwise, iter is left invalid and false is returned.
             virtual void SetValue(const TreeIter &it, int idx, void *value) = 0;
             virtual void SetValue(const TreeIter &it, int idx, bool value) = 0;
 
+            /** Calls visitor for the value of the column idx of every row.
+
+The rows are visited depth first, the same GValue is reused for every row, so the visit doesn't allocate memory for numbers and for the strings of the models that keep them in C++ memory; the visitor returns false to stop. The model must not be modified during the visit.
+
+\example
+bool Exporter::write(const gtk::TreeIter &it, const GValue *value) {
+    out_ << g_value_get_int(value) << "\n";
+    return true;
+}
+...
+model.VisitColumn(0, &Exporter::write, this);
+\endexample
+            */
+            template <typename T>
+            void VisitColumn(int idx /**< the column to visit */,
+                             bool (T::*visitor)(const TreeIter &, const GValue *) /**< the method called for every row */,
+                             T *base /**< the object the method belongs to */) {
+                visit_column(idx, visitor, base);
+            }
+            /// Calls visitor for the string in the column idx of every row, without copying it in a std::string, see VisitColumn().
+            template <typename T>
+            void VisitColumn(int idx, bool (T::*visitor)(const TreeIter &, const char *), T *base) {
+                StringVisitor<T> v(visitor, base);
+                visit_column(idx, &StringVisitor<T>::visit, &v);
+            }
+/// DOXYS_OFF
+        private:
+            template <typename T>
+            struct StringVisitor {
+                bool (T::*fnc_)(const TreeIter &, const char *);
+                T *obj_;
+                StringVisitor(bool (T::*f)(const TreeIter &, const char *), T *o) : fnc_(f), obj_(o) {}
+                bool visit(const TreeIter &it, const GValue *value) {
+                    return (obj_->*fnc_)(it, G_VALUE_HOLDS_STRING(value) ? g_value_get_string(value) : NULL);
+                }
+            };
+            template <typename T>
+            void visit_column(int idx, bool (T::*visitor)(const TreeIter &, const GValue *), T *base) {
+                GtkTreeModel *model = *this;
+                bool list = (gtk_tree_model_get_flags(model) & GTK_TREE_MODEL_LIST_ONLY) != 0;
+                TreeIter it, next;
+                GValue value;
+                memset(&value, 0, sizeof(value));
+
+                if (!gtk_tree_model_get_iter_first(model, &it))
+                    return;
+                for (;;) {
+                    gtk_tree_model_get_value(model, &it, idx, &value);
+                    bool go_on = (base->*visitor)(it, &value);
+                    g_value_unset(&value);
+                    if (!go_on)
+                        return;
+
+                    if (!list && gtk_tree_model_iter_children(model, &next, &it)) {
+                        it = next;
+                        continue;
+                    }
+                    // the next sibling, or the next sibling of the nearest ancestor that has one
+                    for (;;) {
+                        next = it;
+                        if (gtk_tree_model_iter_next(model, &next))
+                            break;
+                        if (list || !gtk_tree_model_iter_parent(model, &next, &it))
+                            return;
+                        it = next;
+                    }
+                    it = next;
+                }
+            }
+        public:
+/// DOXYS_ON
+
             ValidIter Children() {
                 ValidIter it;
                 it.valid = gtk_tree_model_iter_children(*this, it, NULL);
@@ -309,10 +741,625 @@ Otherwise, iter is left invalid and false is returned.
                       const TreePath &path /**< A TreePath */) {
                 return gtk_tree_model_get_iter(*this, &iter, path);
             }
+
+            class RowRange;
+
+            /** A row of a TreeModel, as returned by the iterators of TreeModel::Range() and TreeModel::DepthFirst().
+
+A Row holds the model and an iterator, it's valid as long as the iterator is. The values are read with the GetValue() overloads of the model, Get<T>() works for int, bool, double, long long, void * and std::string columns.
+            */
+            class Row
+            {
+                    TreeModel *model_;
+                    TreeIter it_;
+
+                    template <typename T>
+                    void get(int col, T &value) const { model_->GetValue(it_, col, value); }
+                    void get(int col, bool &value) const {
+                        int v = 0;
+                        model_->GetValue(it_, col, v);
+                        value = v != 0;
+                    }
+                public:
+                    Row(TreeModel &model, const TreeIter &it) : model_(&model), it_(it) {}
+
+                    /// Returns the value of the column col.
+                    template <typename T>
+                    T Get(int col) const {
+                        T value = T();
+                        get(col, value);
+                        return value;
+                    }
+                    /// Reads the string of the column col without copying it, see StringRef.
+                    void Get(int col, StringRef &value) const { model_->GetValue(it_, col, value); }
+                    /// Returns the iterator of the row.
+                    const TreeIter &Iter() const { return it_; }
+                    operator const TreeIter &() const { return it_; }
+                    /// Returns the path of the row.
+                    TreePath Path() const { return model_->Path(it_); }
+                    /// Returns the model of the row.
+                    TreeModel &Model() const { return *model_; }
+                    /// Returns true if the row has children.
+                    bool HasChildren() const { return gtk_tree_model_iter_has_child(*model_, const_cast<TreeIter *>(&it_)); }
+                    /// Returns the children of the row.
+                    RowRange Children() const;
+            };
+
+            /** A forward iterator on the rows of a TreeModel.
+
+The iterator walks the siblings of a row, or all the rows under a parent depth first (parents before their children), see TreeModel::Range() and TreeModel::DepthFirst(). Like TreeIter, it's invalidated when the model changes, unless the model has persistent iterators and the current row isn't removed.
+            */
+            class RowIterator
+            {
+                    TreeModel *model_;
+                    TreeIter it_;
+                    bool valid_;
+                    bool deep_;
+                    bool list_;
+                    int level_;
+
+                    void next() {
+                        GtkTreeModel *model = *model_;
+                        TreeIter n;
+                        if (deep_ && !list_ && gtk_tree_model_iter_children(model, &n, &it_)) {
+                            it_ = n;
+                            ++level_;
+                            return;
+                        }
+                        // the next sibling, or the next sibling of the nearest ancestor below the start level
+                        for (;;) {
+                            n = it_;
+                            if (gtk_tree_model_iter_next(model, &n)) {
+                                it_ = n;
+                                return;
+                            }
+                            if (!deep_ || level_ == 0 || !gtk_tree_model_iter_parent(model, &n, &it_)) {
+                                valid_ = false;
+                                return;
+                            }
+                            it_ = n;
+                            --level_;
+                        }
+                    }
+                public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef Row value_type;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef const Row *pointer;
+                    typedef Row reference;
+
+                    /// Creates the end iterator.
+                    RowIterator() : model_(NULL), valid_(false), deep_(false), list_(true), level_(0) {}
+/// DOXYS_OFF
+                    RowIterator(TreeModel &model, const TreeIter *parent, bool deep) :
+                        model_(&model), deep_(deep), level_(0) {
+                        list_ = (gtk_tree_model_get_flags(model) & GTK_TREE_MODEL_LIST_ONLY) != 0;
+                        valid_ = gtk_tree_model_iter_children(model, &it_, const_cast<TreeIter *>(parent));
+                    }
+/// DOXYS_ON
+                    Row operator*() const { return Row(*model_, it_); }
+                    RowIterator &operator++() {
+                        if (valid_)
+                            next();
+                        return *this;
+                    }
+                    RowIterator operator++(int) {
+                        RowIterator old(*this);
+                        ++*this;
+                        return old;
+                    }
+                    bool operator==(const RowIterator &o) const {
+                        if (!valid_ || !o.valid_)
+                            return valid_ == o.valid_;
+                        return model_ == o.model_ && it_.stamp == o.it_.stamp && it_.user_data == o.it_.user_data &&
+                               it_.user_data2 == o.it_.user_data2 && it_.user_data3 == o.it_.user_data3;
+                    }
+                    bool operator!=(const RowIterator &o) const { return !(*this == o); }
+                    /// Returns the iterator of the current row.
+                    const TreeIter &Iter() const { return it_; }
+                    /// Returns the depth of the current row from the start of the walk, 0 for the first level.
+                    int Level() const { return level_; }
+            };
+
+            /** The rows returned by TreeModel::Range() and TreeModel::DepthFirst(), to be used in a range based for loop.
+
+\example
+for (gtk::TreeModel::Row row : model.Range())
+    total += row.Get<int>(1);
+
+for (auto row : model.DepthFirst())
+    std::cerr << row.Path().str() << " " << row.Get<std::string>(0) << "\n";
+\endexample
+            */
+            class RowRange
+            {
+                    TreeModel *model_;
+                    TreeIter parent_;
+                    bool has_parent_;
+                    bool deep_;
+                public:
+/// DOXYS_OFF
+                    RowRange(TreeModel &model, const TreeIter *parent, bool deep) :
+                        model_(&model), has_parent_(parent != NULL), deep_(deep) {
+                        if (parent)
+                            parent_ = *parent;
+                    }
+/// DOXYS_ON
+                    RowIterator begin() const { return RowIterator(*model_, has_parent_ ? &parent_ : NULL, deep_); }
+                    RowIterator end() const { return RowIterator(); }
+            };
+
+            /// Returns the rows at the top level of the model.
+            RowRange Range() { return RowRange(*this, NULL, false); }
+            /// Returns the children of parent.
+            RowRange Range(const TreeIter &parent) { return RowRange(*this, &parent, false); }
+            /// Returns all the rows of the model depth first, every parent comes before its children.
+            RowRange DepthFirst() { return RowRange(*this, NULL, true); }
+            /// Returns the descendants of parent depth first.
+            RowRange DepthFirst(const TreeIter &parent) { return RowRange(*this, &parent, true); }
+
+            /** Returns the values of the column col of every row, depth first.
+
+The snapshot is a plain vector that can be sorted, searched or processed by parallel algorithms without touching the model, see Row::Get() for the supported types.
+            */
+            template <typename T>
+            std::vector<T> Snapshot(int col) {
+                std::vector<T> values;
+                if (gtk_tree_model_get_flags(*this) & GTK_TREE_MODEL_LIST_ONLY)
+                    values.reserve(ChildrenNumber());
+                for (RowIterator it = DepthFirst().begin(); it != RowIterator(); ++it)
+                    values.push_back((*it).template Get<T>(col));
+                return values;
+            }
     };
 
+    inline TreeModel::RowRange TreeModel::Row::Children() const {
+        return RowRange(*model_, &it_, false);
+    }
+
     typedef std::vector<GType> TypeList;
 
+/** Maps a C++ type to the GType of a model column.
+
+ColumnType is specialized for int, unsigned, bool, float, double, gint64, guint64, std::string, const char *, gpointer and GdkPixbuf *, every specialization provides the GType of the column and the functions to move a value in and out of a GValue. Specialize it to use other types in a TypedListStore, a TypedTreeStore or a TreeViewColumn::CellData() formatter.
+
+\note A const char * points into the GValue it was read from, so it's accepted only by the TreeViewColumn::CellData() formatters, where the value outlives the call: TypedListStore, TypedTreeStore and CustomCellRenderer::Value() reject it at compile time, use std::string there.
+*/
+    template <typename T> struct ColumnType;
+
+/// DOXYS_OFF
+#define OOGTK_COLUMN_TYPE(ctype, gtype, setter, getter) \
+    template <> struct ColumnType<ctype> { \
+        static constexpr GType Type() { return gtype; } \
+        static void Set(GValue *v, const ctype &value) { setter(v, value); } \
+        static ctype Get(const GValue *v) { return getter(v); } \
+    }
+
+    OOGTK_COLUMN_TYPE(int, G_TYPE_INT, g_value_set_int, g_value_get_int);
+    OOGTK_COLUMN_TYPE(unsigned, G_TYPE_UINT, g_value_set_uint, g_value_get_uint);
+    OOGTK_COLUMN_TYPE(float, G_TYPE_FLOAT, g_value_set_float, g_value_get_float);
+    OOGTK_COLUMN_TYPE(double, G_TYPE_DOUBLE, g_value_set_double, g_value_get_double);
+    OOGTK_COLUMN_TYPE(gint64, G_TYPE_INT64, g_value_set_int64, g_value_get_int64);
+    OOGTK_COLUMN_TYPE(guint64, G_TYPE_UINT64, g_value_set_uint64, g_value_get_uint64);
+    OOGTK_COLUMN_TYPE(gpointer, G_TYPE_POINTER, g_value_set_pointer, g_value_get_pointer);
+#undef OOGTK_COLUMN_TYPE
+
+    template <> struct ColumnType<bool> {
+        static constexpr GType Type() { return G_TYPE_BOOLEAN; }
+        static void Set(GValue *v, bool value) { g_value_set_boolean(v, value); }
+        static bool Get(const GValue *v) { return g_value_get_boolean(v) != FALSE; }
+    };
+    // the stores copy the string when the value is stored, no need to duplicate it here
+    template <> struct ColumnType<std::string> {
+        static constexpr GType Type() { return G_TYPE_STRING; }
+        static void Set(GValue *v, const std::string &value) { g_value_set_static_string(v, value.c_str()); }
+        static std::string Get(const GValue *v) {
+            const char *s = g_value_get_string(v);
+            return s ? s : "";
+        }
+    };
+    // the returned string is owned by the GValue, no copy is made: valid only while the GValue is
+    template <> struct ColumnType<const char *> {
+        static constexpr GType Type() { return G_TYPE_STRING; }
+        static void Set(GValue *v, const char *value) { g_value_set_static_string(v, value); }
+        static const char *Get(const GValue *v) { return g_value_get_string(v); }
+    };
+    // the returned pixbuf is owned by the model
+    template <> struct ColumnType<GdkPixbuf *> {
+        static GType Type() { return GDK_TYPE_PIXBUF; }
+        static void Set(GValue *v, GdkPixbuf *value) { g_value_set_object(v, value); }
+        static GdkPixbuf *Get(const GValue *v) { return GDK_PIXBUF(g_value_get_object(v)); }
+    };
+/// DOXYS_ON
+
+    /** The values of a single row, used to insert rows in bulk.
+
+A RowValues holds a GValue for every column of a model, the values are converted to the column types when set, a column that is not set gets its default value (0, false or NULL).
+
+\sa ListStore::AppendRows(), TreeStore::AppendChildren()
+    */
+    class RowValues
+    {
+/// DOXYS_OFF
+            std::vector<GValue> values_;
+            std::vector<gint> columns_;
+
+            GValue *cell(int col) {
+                if (col < 0 || col >= (int)values_.size())
+                    throw std::runtime_error("RowValues: invalid column");
+                return &values_[col];
+            }
+            void init(const TypeList &types) {
+                GValue zero;
+                memset(&zero, 0, sizeof(zero));
+                values_.assign(types.size(), zero);
+                for (size_t i = 0; i < types.size(); ++i) {
+                    g_value_init(&values_[i], types[i]);
+                    columns_.push_back(i);
+                }
+            }
+            RowValues(const RowValues &);
+            RowValues &operator=(const RowValues &);
+        public:
+            // conversions shared with the other row containers, the target must be already initialized
+            static void Store(GValue *dst, const GValue &src) {
+                if (!g_value_transform(&src, dst))
+                    throw std::runtime_error(std::string("cannot convert a value to ") + G_VALUE_TYPE_NAME(dst));
+            }
+            static void Store(GValue *dst, int value) {
+                if (G_VALUE_HOLDS_INT(dst))
+                    g_value_set_int(dst, value);
+                else {
+                    GValue src;
+                    memset(&src, 0, sizeof(src));
+                    g_value_init(&src, G_TYPE_INT);
+                    g_value_set_int(&src, value);
+                    Store(dst, src);
+                }
+            }
+            static void Store(GValue *dst, double value) {
+                if (G_VALUE_HOLDS_DOUBLE(dst))
+                    g_value_set_double(dst, value);
+                else {
+                    GValue src;
+                    memset(&src, 0, sizeof(src));
+                    g_value_init(&src, G_TYPE_DOUBLE);
+                    g_value_set_double(&src, value);
+                    Store(dst, src);
+                }
+            }
+            static void Store(GValue *dst, bool value) {
+                if (G_VALUE_HOLDS_BOOLEAN(dst))
+                    g_value_set_boolean(dst, value);
+                else
+                    Store(dst, value ? 1 : 0);
+            }
+            static void Store(GValue *dst, const char *value) {
+                if (!G_VALUE_HOLDS_STRING(dst))
+                    throw std::runtime_error("cannot store a string in a column of type " + std::string(G_VALUE_TYPE_NAME(dst)));
+                g_value_set_string(dst, value);
+            }
+            static void Store(GValue *dst, void *value) {
+                if (G_VALUE_HOLDS_OBJECT(dst))
+                    g_value_set_object(dst, value);
+                else
+                    g_value_set_pointer(dst, value);
+            }
+/// DOXYS_ON
+            /// Creates the values for a row with the given column types.
+            RowValues(const TypeList &types) { init(types); }
+            /// Creates the values for a row of model.
+            RowValues(GtkTreeModel *model) {
+                TypeList types;
+                for (int i = 0; i < gtk_tree_model_get_n_columns(model); ++i)
+                    types.push_back(gtk_tree_model_get_column_type(model, i));
+                init(types);
+            }
+            ~RowValues() {
+                for (size_t i = 0; i < values_.size(); ++i)
+                    g_value_unset(&values_[i]);
+            }
+
+            void Set(int col, int value) { Store(cell(col), value); }
+            void Set(int col, double value) { Store(cell(col), value); }
+            void Set(int col, bool value) { Store(cell(col), value); }
+            void Set(int col, const char *value) { Store(cell(col), value); }
+            void Set(int col, const std::string &value) { Store(cell(col), value.c_str()); }
+            /// Sets a pointer or a GObject column (a Pixbuf for instance), objects are referenced by the model when the row is inserted.
+            void Set(int col, void *value) { Store(cell(col), value); }
+
+            /// Restores the default value of every column.
+            void Reset() {
+                for (size_t i = 0; i < values_.size(); ++i)
+                    g_value_reset(&values_[i]);
+            }
+            /// Returns the number of columns.
+            int Size() const { return values_.size(); }
+            /// Returns the values, suitable for gtk_list_store_insert_with_valuesv().
+            GValue *Values() { return &values_[0]; }
+            /// Returns the column indexes, suitable for gtk_list_store_insert_with_valuesv().
+            gint *Columns() { return &columns_[0]; }
+    };
+
+    /** Rows of values prepared out of a model.
+
+A RowTable keeps the values of all its rows in a single vector of GValues, converted to the column types when set like RowValues. It doesn't touch any model, so it can be filled in a worker thread and handed to the main loop.
+
+\sa ListStore::Snapshot, TreeStore::Subtree
+    */
+    class RowTable
+    {
+/// DOXYS_OFF
+        protected:
+            TypeList types_;
+            std::vector<GValue> values_;
+            std::vector<gint> columns_;
+            int rows_;
+
+            GValue *cell(int row, int col) {
+                if (row < 0 || row >= Size() || col < 0 || col >= (int)types_.size())
+                    throw std::runtime_error("RowTable: invalid row or column");
+                return &values_[row * types_.size() + col];
+            }
+            GValue *row_values(int row) { return values_.data() + row * types_.size(); }
+            // appends a row with the default values
+            int add() {
+                GValue zero;
+                memset(&zero, 0, sizeof(zero));
+                size_t first = values_.size();
+                values_.resize(first + types_.size(), zero);
+                for (size_t i = 0; i < types_.size(); ++i)
+                    g_value_init(&values_[first + i], types_[i]);
+                return rows_++;
+            }
+            // throws if the columns are not the ones of model
+            void check(GtkTreeModel *model, const char *what) const {
+                bool same = (int)types_.size() == gtk_tree_model_get_n_columns(model);
+                for (size_t i = 0; same && i < types_.size(); ++i)
+                    same = types_[i] == gtk_tree_model_get_column_type(model, i);
+                if (!same)
+                    throw std::runtime_error(std::string(what) + ": the columns don't match the store");
+            }
+        private:
+            void init() {
+                for (size_t i = 0; i < types_.size(); ++i)
+                    columns_.push_back(i);
+            }
+            RowTable(const RowTable &);
+            RowTable &operator=(const RowTable &);
+/// DOXYS_ON
+        public:
+            /// Creates an empty table for the columns of model.
+            RowTable(GtkTreeModel *model) : rows_(0) {
+                for (int i = 0; i < gtk_tree_model_get_n_columns(model); ++i)
+                    types_.push_back(gtk_tree_model_get_column_type(model, i));
+                init();
+            }
+            /// Creates an empty table with the given column types.
+            RowTable(const TypeList &types) : types_(types), rows_(0) { init(); }
+            ~RowTable() {
+                for (size_t i = 0; i < values_.size(); ++i)
+                    g_value_unset(&values_[i]);
+            }
+            /// Reserves the memory for rows rows.
+            void Reserve(int rows) { values_.reserve(rows * types_.size()); }
+
+            void Set(int row, int col, int value) { RowValues::Store(cell(row, col), value); }
+            void Set(int row, int col, double value) { RowValues::Store(cell(row, col), value); }
+            void Set(int row, int col, bool value) { RowValues::Store(cell(row, col), value); }
+            void Set(int row, int col, const char *value) { RowValues::Store(cell(row, col), value); }
+            void Set(int row, int col, const std::string &value) { RowValues::Store(cell(row, col), value.c_str()); }
+            /// Sets a pointer or a GObject column, objects are referenced by the table.
+            void Set(int row, int col, void *value) { RowValues::Store(cell(row, col), value); }
+
+            /// Returns the number of rows.
+            int Size() const { return rows_; }
+    };
+
+    /** Prepares a model for a bulk update.
+
+While a BulkUpdate object exists the sorting of the model, if it's a sortable model like ListStore and TreeStore, is disabled, so the inserted rows don't have to be placed in order one by one, and the optional TreeView is detached from the model, so it doesn't process the signals of every single change. When the object is destroyed the sort column is restored, the model is sorted once, and the view is attached again.
+
+\note A TreeView loses its selection, cursor and expanded rows when it is detached from its model.
+
+\example
+{
+    gtk::BulkUpdate bulk(store, view);
+    for (size_t i = 0; i < items.size(); ++i)
+        store.AddTail(0, items[i].c_str(), -1);
+} // the store is sorted and shown again here
+\endexample
+    */
+    class BulkUpdate
+    {
+/// DOXYS_OFF
+            GtkTreeModel *model_;
+            GtkTreeView *view_;
+            gint sort_id_;
+            GtkSortType order_;
+
+            BulkUpdate(const BulkUpdate &);
+            BulkUpdate &operator=(const BulkUpdate &);
+/// DOXYS_ON
+        public:
+            BulkUpdate(GtkTreeModel *model /**< the model that will be updated */,
+                       GtkTreeView *view = NULL /**< an optional view showing the model, it's detached until the update is completed */,
+                       bool unsort = true /**< false keeps the sorting, for updates that can't change the order like removals */) :
+                model_(model), view_(NULL), sort_id_(GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID), order_(GTK_SORT_ASCENDING) {
+                g_object_ref(model_);
+
+                if (view && gtk_tree_view_get_model(view) == model_) {
+                    view_ = view;
+                    g_object_ref(view_);
+                    gtk_tree_view_set_model(view_, NULL);
+                }
+                if (unsort && GTK_IS_TREE_SORTABLE(model_)) {
+                    gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(model_), &sort_id_, &order_);
+                    if (sort_id_ != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+                        gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model_),
+                                GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID, order_);
+                }
+            }
+            ~BulkUpdate() {
+                if (sort_id_ != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+                    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model_), sort_id_, order_);
+                if (view_) {
+                    gtk_tree_view_set_model(view_, model_);
+                    g_object_unref(view_);
+                }
+                g_object_unref(model_);
+            }
+    };
+
+    /** Coalesces the row-changed signals of a list model.
+
+Every ListStore::SetValue() or ListStore::Set() emits a row-changed signal, and every view attached to the store invalidates and measures the row again; a grid updated tens of thousands of times per second spends most of its time in these handlers. While a RowChangeBuffer exists the row-changed handlers connected to the model are blocked, the changed rows are only recorded, and once per interval (a frame by default) a single row-changed is emitted for every changed row.
+
+The values are written in the model immediately, so who reads the model always gets the current values; only the signal is deferred. Inserted, deleted and reordered rows are signaled as usual and the recorded rows follow them.
+
+\example
+gtk::RowChangeBuffer buffer(prices);
+...
+void MyApp::tick(int row, double price) {
+    prices.Set(rows_[row], 2, price, -1); // no signal here
+}
+\endexample
+
+\note The handlers connected to the model while the buffer exists get the signals immediately until the next commit. Only list models are supported, other models throw a std::runtime_error. A second buffer on the same model does nothing.
+    */
+    class RowChangeBuffer
+    {
+/// DOXYS_OFF
+            GtkTreeModel *model_;
+            std::vector<gulong> blocked_;
+            std::vector<int> dirty_;
+            gulong changed_, inserted_, deleted_, reordered_;
+            guint source_;
+            int interval_;
+
+            RowChangeBuffer(const RowChangeBuffer &);
+            RowChangeBuffer &operator=(const RowChangeBuffer &);
+
+            void block() {
+                guint id = g_signal_lookup("row-changed", GTK_TYPE_TREE_MODEL);
+                while (gulong h = g_signal_handler_find(model_, GSignalMatchType(G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_UNBLOCKED),
+                                                        id, 0, NULL, NULL, NULL)) {
+                    g_signal_handler_block(model_, h);
+                    blocked_.push_back(h);
+                }
+                changed_ = g_signal_connect(model_, "row-changed", GCallback(row_changed), this);
+            }
+            void unblock() {
+                g_signal_handler_disconnect(model_, changed_);
+                for (size_t i = 0; i < blocked_.size(); ++i)
+                    if (g_signal_handler_is_connected(model_, blocked_[i]))
+                        g_signal_handler_unblock(model_, blocked_[i]);
+                blocked_.clear();
+            }
+            static void row_changed(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, RowChangeBuffer *b) {
+                b->dirty_.push_back(gtk_tree_path_get_indices(path)[0]);
+                if (!b->source_)
+                    b->source_ = g_timeout_add_full(G_PRIORITY_DEFAULT, b->interval_, GSourceFunc(timeout), b, NULL);
+            }
+            static void row_inserted(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, RowChangeBuffer *b) {
+                int row = gtk_tree_path_get_indices(path)[0];
+                for (size_t i = 0; i < b->dirty_.size(); ++i)
+                    if (b->dirty_[i] >= row)
+                        ++b->dirty_[i];
+            }
+            static void row_deleted(GtkTreeModel *, GtkTreePath *path, RowChangeBuffer *b) {
+                int row = gtk_tree_path_get_indices(path)[0];
+                size_t j = 0;
+                for (size_t i = 0; i < b->dirty_.size(); ++i) {
+                    if (b->dirty_[i] != row)
+                        b->dirty_[j++] = b->dirty_[i] > row ? b->dirty_[i] - 1 : b->dirty_[i];
+                }
+                b->dirty_.resize(j);
+            }
+            // new_order[new position] = old position
+            static void rows_reordered(GtkTreeModel *model, GtkTreePath *, GtkTreeIter *, gint *new_order, RowChangeBuffer *b) {
+                if (b->dirty_.empty())
+                    return;
+                std::vector<int> position(gtk_tree_model_iter_n_children(model, NULL));
+                for (size_t i = 0; i < position.size(); ++i)
+                    position[new_order[i]] = i;
+                for (size_t i = 0; i < b->dirty_.size(); ++i)
+                    b->dirty_[i] = position[b->dirty_[i]];
+            }
+            static gboolean timeout(RowChangeBuffer *b) {
+                b->source_ = 0;
+                b->Commit();
+                return FALSE;
+            }
+/// DOXYS_ON
+        public:
+            RowChangeBuffer(GtkTreeModel *model /**< a list model, like a ListStore */,
+                            int interval = 16 /**< milliseconds between the commits */) :
+                model_(NULL), changed_(0), inserted_(0), deleted_(0), reordered_(0), source_(0), interval_(interval) {
+                if (!(gtk_tree_model_get_flags(model) & GTK_TREE_MODEL_LIST_ONLY))
+                    throw std::runtime_error("RowChangeBuffer: only list models are supported");
+                if (g_object_get_data(G_OBJECT(model), "oogtk-row-buffer"))
+                    return;
+                model_ = model;
+                g_object_ref(model_);
+                g_object_set_data(G_OBJECT(model_), "oogtk-row-buffer", this);
+                block();
+                inserted_ = g_signal_connect(model_, "row-inserted", GCallback(row_inserted), this);
+                deleted_ = g_signal_connect(model_, "row-deleted", GCallback(row_deleted), this);
+                reordered_ = g_signal_connect(model_, "rows-reordered", GCallback(rows_reordered), this);
+            }
+            /// Emits the pending signals and restores the handlers of the model.
+            ~RowChangeBuffer() {
+                if (!model_)
+                    return;
+                Commit();
+                unblock();
+                g_signal_handler_disconnect(model_, inserted_);
+                g_signal_handler_disconnect(model_, deleted_);
+                g_signal_handler_disconnect(model_, reordered_);
+                g_object_set_data(G_OBJECT(model_), "oogtk-row-buffer", NULL);
+                g_object_unref(model_);
+            }
+            /** Emits a row-changed signal for every row changed since the last commit.
+
+It's called by a timeout once per interval, call it directly to show the changes at once.
+            */
+            void Commit() {
+                if (!model_)
+                    return;
+                if (source_) {
+                    g_source_remove(source_);
+                    source_ = 0;
+                }
+                if (dirty_.empty())
+                    return;
+
+                std::vector<int> rows;
+                rows.swap(dirty_);
+                std::sort(rows.begin(), rows.end());
+                rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+                // the handlers connected in the meantime are blocked again too
+                unblock();
+                GtkTreePath *path = gtk_tree_path_new_first();
+                GtkTreeIter it;
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    if (gtk_tree_model_iter_nth_child(model_, &it, NULL, rows[i])) {
+                        gtk_tree_path_get_indices(path)[0] = rows[i];
+                        gtk_tree_model_row_changed(model_, path, &it);
+                    }
+                }
+                gtk_tree_path_free(path);
+                block();
+            }
+            /// Returns true if some rows changed since the last commit.
+            bool Pending() const { return !dirty_.empty(); }
+            /// Returns the milliseconds between the commits.
+            int Interval() const { return interval_; }
+            /// Sets the milliseconds between the commits, the next commit already scheduled is not moved.
+            void Interval(int msec) { interval_ = msec; }
+    };
+
     class ListStore : public TreeModel
     {
         public:
@@ -409,6 +1456,234 @@ Otherwise, iter is left invalid and false is returned.
             void Clear() {
                 gtk_list_store_clear(*this);
             }
+            /** Removes the rows with the given indexes.
+
+The rows are removed starting from the last one, so the indexes stay valid during the removal. The optional view is detached from the store until the removal is done, see BulkUpdate; the sorting of the store is left alone, removing rows doesn't change the order of the others. Without a view, wrap the call in a TreeSelection::Batch to get a single "changed" signal from the selection of the views.
+
+\example
+std::vector<int> rows;
+tv.Selection().SelectedRows(rows);
+store.RemoveRows(rows, tv);
+\endexample
+            */
+            void RemoveRows(const std::vector<int> &rows, GtkTreeView *view = NULL) {
+                std::vector<int> sorted(rows);
+                std::sort(sorted.begin(), sorted.end());
+                sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+                BulkUpdate bulk(*this, view, false);
+                TreeIter it;
+                for (size_t i = sorted.size(); i-- > 0; )
+                    if (gtk_tree_model_iter_nth_child(*this, &it, NULL, sorted[i]))
+                        gtk_list_store_remove(*this, &it);
+            }
+
+            /** Appends count rows to the store.
+
+The filler method is called for every new row with the row number (from 0 to count - 1) and the values to set, every row is inserted with all its values at once, with a single row-inserted signal. Sorting is suspended during the insertion, and the optional view is detached from the store, see BulkUpdate.
+
+\example
+void MyApp::fill(int row, gtk::RowValues &values) {
+    values.Set(0, items_[row].name);
+    values.Set(1, items_[row].size);
+}
+...
+store.AppendRows(items_.size(), &MyApp::fill, this, treeview);
+\endexample
+            */
+            template <typename T>
+            void AppendRows(int count /**< number of rows to append */,
+                            void (T::*filler)(int, RowValues &) /**< the method that sets the values of every row */,
+                            T *base /**< the object the method belongs to */,
+                            GtkTreeView *view = NULL /**< an optional TreeView showing the store */) {
+                RowValues values(*this);
+                BulkUpdate bulk(*this, view);
+                TreeIter it;
+
+                for (int i = 0; i < count; ++i) {
+                    values.Reset();
+                    (base->*filler)(i, values);
+                    gtk_list_store_insert_with_valuesv(*this, &it, -1, values.Columns(), values.Values(), values.Size());
+                }
+            }
+
+            /** The new content of a store, to be applied with ListStore::Apply().
+
+The rows are numbered in the order they are added, see RowTable for the setters.
+
+\example
+gtk::ListStore::Snapshot snap(store);
+snap.Reserve(orders.size());
+for (size_t i = 0; i < orders.size(); ++i) {
+    int row = snap.Add();
+    snap.Set(row, 0, orders[i].id);
+    snap.Set(row, 1, orders[i].status);
+}
+store.Apply(snap, 0);
+\endexample
+            */
+            class Snapshot : public RowTable
+            {
+                    friend class ListStore;
+                public:
+                    /// Creates an empty snapshot for the columns of model.
+                    Snapshot(GtkTreeModel *model) : RowTable(model) {}
+                    /// Creates an empty snapshot with the given column types.
+                    Snapshot(const TypeList &types) : RowTable(types) {}
+                    /// Adds a row with the default values. \return the number of the new row.
+                    int Add() { return add(); }
+            };
+            /// The number of rows touched by ListStore::Apply().
+            struct Changes {
+                int inserted; /**< rows of the snapshot whose key wasn't in the store */
+                int deleted; /**< rows of the store whose key isn't in the snapshot */
+                int moved; /**< rows kept at a different position among the kept rows */
+                int changed; /**< rows kept with at least a different value */
+            };
+            /** Updates the store to the content of a snapshot with the fewest signals.
+
+The rows of the store and of the snapshot are matched by the value of the key column (an integer or a string column, every key in the snapshot must be unique), in a time linear in the number of rows. Then:
+- the kept rows with different values are updated with a row-changed each, only the different columns are written;
+- the rows whose key isn't in the snapshot are removed;
+- the kept rows are moved to the order of the snapshot with a single rows-reordered;
+- the new rows are inserted at their position with all their values.
+
+Rows that didn't change get no signal at all, so the views keep their selection, cursor and scroll position and redraw only what changed, a periodic full refresh of a table where little changes costs little more than reading it.
+
+\note A sorted store keeps its own order, the rows are not reordered.
+\note The store hands out copies of the boxed values, G_TYPE_STRV and GdkColor columns are compared by content, the other boxed columns can't be compared: they are written in every kept row, with a row-changed, but a row isn't counted as changed for them.
+\return the number of inserted, deleted, moved and changed rows.
+            */
+            Changes Apply(Snapshot &snap /**< the new content of the store */,
+                          int key /**< the column identifying the rows */) {
+                GtkTreeModel *model = *this;
+                snap.check(model, "Snapshot");
+                int cols = snap.types_.size();
+                if (key < 0 || key >= cols)
+                    throw std::runtime_error("ListStore: invalid key column");
+
+                int rows = snap.Size();
+                std::unordered_map<std::string, int> wanted;
+                wanted.reserve(rows);
+                for (int i = 0; i < rows; ++i)
+                    if (!wanted.insert(std::make_pair(key_of(snap.cell(i, key)), i)).second)
+                        throw std::runtime_error("Snapshot: duplicate key");
+
+                // matches the rows of the store, the unknown and the repeated keys are removed
+                std::vector<int> kept(rows, -1);
+                std::vector<TreeIter> iters(rows), removed;
+                TreeIter it;
+                GValue v;
+                memset(&v, 0, sizeof(v));
+                int n = 0;
+                for (bool valid = gtk_tree_model_get_iter_first(model, &it); valid; valid = gtk_tree_model_iter_next(model, &it)) {
+                    gtk_tree_model_get_value(model, &it, key, &v);
+                    std::unordered_map<std::string, int>::const_iterator w = wanted.find(key_of(&v));
+                    g_value_unset(&v);
+                    if (w == wanted.end() || kept[w->second] >= 0)
+                        removed.push_back(it);
+                    else {
+                        kept[w->second] = n++;
+                        iters[w->second] = it;
+                    }
+                }
+
+                Changes c = { 0, (int)removed.size(), 0, 0 };
+                // the iterators of a ListStore persist, the kept rows are updated before the others move
+                std::vector<gint> columns;
+                std::vector<GValue> values;
+                for (int i = 0; i < rows; ++i) {
+                    if (kept[i] < 0)
+                        continue;
+                    columns.clear();
+                    values.clear();
+                    bool different = false;
+                    for (int col = 0; col < cols; ++col) {
+                        GValue *value = snap.cell(i, col);
+                        if (comparable(value)) {
+                            gtk_tree_model_get_value(model, &iters[i], col, &v);
+                            bool same = same_value(&v, value);
+                            g_value_unset(&v);
+                            if (same)
+                                continue;
+                            different = true;
+                        }
+                        columns.push_back(col);
+                        values.push_back(*value);
+                    }
+                    if (!columns.empty()) {
+                        gtk_list_store_set_valuesv(*this, &iters[i], &columns[0], &values[0], columns.size());
+                        if (different)
+                            c.changed++;
+                    }
+                }
+                for (size_t i = removed.size(); i-- > 0; )
+                    gtk_list_store_remove(*this, &removed[i]);
+
+                gint sort_id;
+                GtkSortType order;
+                gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(model), &sort_id, &order);
+                if (sort_id == GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID) {
+                    std::vector<gint> new_order;
+                    new_order.reserve(n);
+                    for (int i = 0; i < rows; ++i)
+                        if (kept[i] >= 0) {
+                            if (kept[i] != (int)new_order.size())
+                                c.moved++;
+                            new_order.push_back(kept[i]);
+                        }
+                    if (c.moved)
+                        gtk_list_store_reorder(*this, &new_order[0]);
+                }
+                // the kept rows are in the snapshot order, every new row goes at its final position
+                for (int i = 0; i < rows; ++i)
+                    if (kept[i] < 0) {
+                        gtk_list_store_insert_with_valuesv(*this, &it, i, &snap.columns_[0], snap.row_values(i), cols);
+                        c.inserted++;
+                    }
+                return c;
+            }
+/// DOXYS_OFF
+        private:
+            static std::string key_of(const GValue *value) {
+                if (G_VALUE_HOLDS_STRING(value)) {
+                    const char *s = g_value_get_string(value);
+                    return s ? s : "";
+                }
+                GValue k;
+                memset(&k, 0, sizeof(k));
+                g_value_init(&k, G_TYPE_INT64);
+                if (!g_value_transform(value, &k))
+                    throw std::runtime_error(std::string("ListStore: a key column can't be of type ") + G_VALUE_TYPE_NAME(value));
+                gint64 n = g_value_get_int64(&k);
+                return std::string(reinterpret_cast<const char *>(&n), sizeof(n));
+            }
+            // the other boxed values are copied by gtk_tree_model_get_value(), a copy is never the same pointer
+            static bool comparable(const GValue *v) {
+                return !G_VALUE_HOLDS_BOXED(v) || G_VALUE_HOLDS(v, G_TYPE_STRV) || G_VALUE_HOLDS(v, GDK_TYPE_COLOR);
+            }
+            // strings, string vectors and colors are compared by content, objects and pointers by address
+            static bool same_value(const GValue *a, const GValue *b) {
+                if (G_VALUE_HOLDS_STRING(a))
+                    return g_strcmp0(g_value_get_string(a), g_value_get_string(b)) == 0;
+                if (G_VALUE_HOLDS(a, G_TYPE_STRV)) {
+                    const gchar * const *x = static_cast<const gchar * const *>(g_value_get_boxed(a));
+                    const gchar * const *y = static_cast<const gchar * const *>(g_value_get_boxed(b));
+                    if (!x || !y)
+                        return x == y;
+                    for (; *x && *y; ++x, ++y)
+                        if (strcmp(*x, *y))
+                            return false;
+                    return *x == *y;
+                }
+                if (G_VALUE_HOLDS(a, GDK_TYPE_COLOR)) {
+                    const GdkColor *x = static_cast<const GdkColor *>(g_value_get_boxed(a));
+                    const GdkColor *y = static_cast<const GdkColor *>(g_value_get_boxed(b));
+                    return x && y ? gdk_color_equal(x, y) : x == y;
+                }
+                return memcmp(&a->data[0], &b->data[0], sizeof(a->data[0])) == 0;
+            }
+/// DOXYS_ON
     };
 
     class TreeStore : public TreeModel
@@ -555,6 +1830,282 @@ Otherwise, iter is left invalid and false is returned.
             void Clear() {
                 gtk_tree_store_clear(*this);
             }
+
+            /** Appends count children to parent.
+
+Like ListStore::AppendRows() the filler method is called for every new row with its index among the new children and the values to set, every row is inserted with its values with a single row-inserted signal, sorting is suspended during the insertion and the optional view is detached from the store.
+            */
+            template <typename T>
+            void AppendChildren(const TreeIter &parent /**< the parent row */,
+                                int count /**< number of children to append */,
+                                void (T::*filler)(int, RowValues &) /**< the method that sets the values of every row */,
+                                T *base /**< the object the method belongs to */,
+                                GtkTreeView *view = NULL /**< an optional TreeView showing the store */) {
+                append_children(&parent, count, filler, base, view);
+            }
+            /// Appends count rows at the top level of the store, see TreeStore::AppendChildren().
+            template <typename T>
+            void AppendChildren(int count, void (T::*filler)(int, RowValues &), T *base, GtkTreeView *view = NULL) {
+                append_children(NULL, count, filler, base, view);
+            }
+
+            /** A subtree prepared out of the store, to be inserted with TreeStore::InsertSubtree().
+
+The nodes are numbered in the order they are added, a node is added under a node that already exists (or at the top of the subtree with -1), see RowTable for the setters.
+
+\example
+gtk::TreeStore::Subtree tree(store);
+int dir = tree.Add();
+tree.Set(dir, 0, "src");
+for (size_t i = 0; i < files.size(); ++i)
+    tree.Set(tree.Add(dir), 0, files[i]);
+int sub = tree.Add(dir);
+tree.Set(sub, 0, "include");
+tree.Lazy(sub); // its children are loaded by a LazyChildren provider
+store.InsertSubtree(tree, tv);
+\endexample
+            */
+            class Subtree : public RowTable
+            {
+/// DOXYS_OFF
+                    std::vector<int> parents_;
+                    std::vector<bool> lazy_;
+                    friend class TreeStore;
+/// DOXYS_ON
+                public:
+                    /// Creates an empty subtree for the columns of model.
+                    Subtree(GtkTreeModel *model) : RowTable(model) {}
+                    /// Creates an empty subtree with the given column types.
+                    Subtree(const TypeList &types) : RowTable(types) {}
+                    /// Adds a node under parent, -1 adds it at the top of the subtree. \return the number of the new node.
+                    int Add(int parent = -1) {
+                        if (parent < -1 || parent >= Size())
+                            throw std::runtime_error("Subtree: invalid parent node");
+                        parents_.push_back(parent);
+                        lazy_.push_back(false);
+                        return add();
+                    }
+                    /// Marks a node without children in the subtree as having children loaded on demand, an empty placeholder child is inserted under it, see LazyChildren.
+                    void Lazy(int node) {
+                        if (node < 0 || node >= Size())
+                            throw std::runtime_error("Subtree: invalid node");
+                        lazy_[node] = true;
+                    }
+            };
+            /** Inserts a prepared subtree under parent.
+
+The nodes are appended after the children of parent, each one with all its values and a single row-inserted signal, and the optional view is detached from the store, see BulkUpdate; at the top level sorting is suspended during the insertion. Don't pass the view from a LazyChildren provider, the row being expanded would be collapsed.
+
+GtkTreeStore finds the position of a row, to append it and to emit its signal, walking its siblings from the first one. The children of the new nodes, and the top nodes of the subtree when parent has no children (or only the placeholder of a lazy row), are inserted from the last one at the front of their level, so every row costs the same however wide its level is. Nodes appended after existing children cost a walk of the siblings each: a level of n rows added under a parent that already has children costs O(n²).
+            */
+            void InsertSubtree(const TreeIter &parent /**< the parent row */,
+                               Subtree &tree /**< the nodes to insert */,
+                               GtkTreeView *view = NULL /**< an optional TreeView showing the store */) {
+                insert_subtree(&parent, tree, view);
+            }
+            /// Inserts a prepared subtree at the top level of the store, see TreeStore::InsertSubtree().
+            void InsertSubtree(Subtree &tree, GtkTreeView *view = NULL) {
+                insert_subtree(NULL, tree, view);
+            }
+/// DOXYS_OFF
+        private:
+            friend class LazyChildren;
+            // the placeholder children of the lazy rows by node, a node reused by a new row is dropped
+            typedef std::unordered_set<gpointer> Placeholders;
+            static void placeholder_reused(GtkTreeModel *, GtkTreePath *, GtkTreeIter *it, Placeholders *p) { p->erase(it->user_data); }
+            static void free_placeholders(gpointer p) { delete static_cast<Placeholders *>(p); }
+            Placeholders *placeholders(bool create) const {
+                Placeholders *p = static_cast<Placeholders *>(g_object_get_data(obj_, "oogtk-placeholders"));
+                if (!p && create) {
+                    p = new Placeholders();
+                    g_object_set_data_full(obj_, "oogtk-placeholders", p, free_placeholders);
+                    g_signal_connect(obj_, "row-inserted", GCallback(placeholder_reused), p);
+                }
+                return p;
+            }
+            void append_placeholder(TreeIter &parent) {
+                Placeholders *p = placeholders(true);
+                TreeIter child;
+                gtk_tree_store_append(*this, &child, &parent);
+                p->insert(child.user_data);
+            }
+            bool is_placeholder(const TreeIter &it) const {
+                Placeholders *p = placeholders(false);
+                return p && p->count(it.user_data);
+            }
+            void remove_row(TreeIter &it) {
+                if (Placeholders *p = placeholders(false))
+                    p->erase(it.user_data);
+                gtk_tree_store_remove(*this, &it);
+            }
+
+            // true if the new rows can go in front of the children of parent
+            bool empty_level(TreeIter *parent) const {
+                GtkTreeModel *model = *this;
+                TreeIter child;
+                if (!gtk_tree_model_iter_children(model, &child, parent))
+                    return true;
+                return is_placeholder(child) && !gtk_tree_model_iter_next(model, &child);
+            }
+            void insert_subtree(const TreeIter *parent, Subtree &tree, GtkTreeView *view) {
+                tree.check(*this, "Subtree");
+
+                int n = tree.Size();
+                std::vector<TreeIter> iters(n);
+                TreeIter p;
+                if (parent)
+                    p = *parent;
+                TreeIter *top = parent ? &p : NULL;
+                bool prepend_top = empty_level(top);
+                // the children of every node (the top nodes at 0, the children of node i at i + 1),
+                // linked from the last one
+                std::vector<int> last(n + 1, -1), prev(n, -1);
+                for (int i = 0; i < n; ++i) {
+                    prev[i] = last[tree.parents_[i] + 1];
+                    last[tree.parents_[i] + 1] = i;
+                }
+                // under a parent the rows are placed by the sort as they are inserted, restoring the
+                // sort would sort the whole tree again
+                BulkUpdate bulk(*this, view, parent == NULL);
+
+                std::vector<int> pending(1, -1), level;
+                while (!pending.empty()) {
+                    int up = pending.back();
+                    pending.pop_back();
+                    level.clear();
+                    for (int i = last[up + 1]; i >= 0; i = prev[i])
+                        level.push_back(i);
+                    // a level is inserted from its last node at position 0, unless it goes after existing rows
+                    bool append = up < 0 && !prepend_top;
+                    if (append)
+                        std::reverse(level.begin(), level.end());
+                    for (size_t k = 0; k < level.size(); ++k) {
+                        int i = level[k];
+                        gtk_tree_store_insert_with_valuesv(*this, &iters[i], up >= 0 ? &iters[up] : top, append ? -1 : 0,
+                                                           &tree.columns_[0], tree.row_values(i), tree.types_.size());
+                        if (tree.lazy_[i])
+                            append_placeholder(iters[i]);
+                        if (last[i + 1] >= 0)
+                            pending.push_back(i);
+                    }
+                }
+            }
+            template <typename T>
+            void append_children(const TreeIter *parent, int count, void (T::*filler)(int, RowValues &), T *base, GtkTreeView *view) {
+                RowValues values(*this);
+                TreeIter it, p;
+                if (parent)
+                    p = *parent;
+                // the parent iterator stays valid, tree store iterators persist; under a parent the sort isn't suspended, see insert_subtree()
+                BulkUpdate bulk(*this, view, parent == NULL);
+
+                for (int i = 0; i < count; ++i) {
+                    values.Reset();
+                    (base->*filler)(i, values);
+                    gtk_tree_store_insert_with_valuesv(*this, &it, parent ? &p : NULL, -1,
+                                                       values.Columns(), values.Values(), values.Size());
+                }
+            }
+/// DOXYS_ON
+    };
+
+    /** Loads the children of the rows of a TreeStore when they are expanded.
+
+A row marked with LazyChildren::Mark() (or TreeStore::Subtree::Lazy()) gets an empty placeholder child, so the views show its expander without its children being in the store. When the row is expanded in the view the provider method is called to insert the real children, usually with TreeStore::AppendChildren() or TreeStore::InsertSubtree(), and the placeholder is removed; if the provider inserts nothing the expander disappears. The provider can mark the new children as lazy too, so a browser on a huge hierarchy only loads the levels the user opens.
+
+\example
+gtk::LazyChildren lazy(store, tv, &MyApp::load, this);
+...
+void MyApp::load(gtk::TreeStore &store, const gtk::TreeIter &dir) {
+    gtk::TreeStore::Subtree entries(store);
+    ... // list the directory, Subtree::Lazy() on the subdirectories
+    store.InsertSubtree(dir, entries);
+}
+\endexample
+
+\note The placeholders are recorded by the store, a real row is never taken for one whatever its values. TreeView::ExpandAll() loads every lazy row.
+    */
+    class LazyChildren
+    {
+/// DOXYS_OFF
+            struct AbstractProvider {
+                virtual ~AbstractProvider() {}
+                virtual void load(TreeStore &store, const TreeIter &parent) = 0;
+            };
+            template <typename T>
+            struct ProviderCbk : public AbstractProvider {
+                void (T::*fnc_)(TreeStore &, const TreeIter &);
+                T *obj_;
+                ProviderCbk(void (T::*fnc)(TreeStore &, const TreeIter &), T *obj) : fnc_(fnc), obj_(obj) {}
+                void load(TreeStore &store, const TreeIter &parent) { (obj_->*fnc_)(store, parent); }
+            };
+
+            TreeStore &store_;
+            GtkTreeView *view_;
+            gulong id_;
+            AbstractProvider *provider_;
+
+            LazyChildren(const LazyChildren &);
+            LazyChildren &operator=(const LazyChildren &);
+
+            // the only child of parent, if it's a placeholder
+            bool placeholder(const TreeIter &parent, TreeIter &child) const {
+                GtkTreeModel *model = store_;
+                TreeIter p = parent;
+                if (gtk_tree_model_iter_n_children(model, &p) != 1 || !gtk_tree_model_iter_children(model, &child, &p))
+                    return false;
+                return store_.is_placeholder(child);
+            }
+            static gboolean test_expand(GtkTreeView *view, GtkTreeIter *iter, GtkTreePath *, LazyChildren *l) {
+                TreeIter child;
+                if (gtk_tree_view_get_model(view) != (GtkTreeModel *)l->store_ || !l->placeholder(*iter, child))
+                    return FALSE;
+
+                // the placeholder is removed last, so the row always has children while they are loaded
+                l->provider_->load(l->store_, *iter);
+                l->store_.remove_row(child);
+                // no children, the expansion is cancelled
+                return !gtk_tree_model_iter_has_child(l->store_, iter);
+            }
+/// DOXYS_ON
+        public:
+            /// Loads the children of the rows expanded in view with the provider method.
+            template <typename T>
+            LazyChildren(TreeStore &store /**< the store */,
+                         GtkTreeView *view /**< a view showing the store */,
+                         void (T::*provider)(TreeStore &, const TreeIter &) /**< the method inserting the children of a row */,
+                         T *base /**< the object the method belongs to */) :
+                store_(store), view_(view), provider_(new ProviderCbk<T>(provider, base)) {
+                g_object_ref(view_);
+                id_ = g_signal_connect(view_, "test-expand-row", GCallback(test_expand), this);
+            }
+            ~LazyChildren() {
+                if (g_signal_handler_is_connected(view_, id_))
+                    g_signal_handler_disconnect(view_, id_);
+                g_object_unref(view_);
+                delete provider_;
+            }
+            /// Marks a row without children as having children loaded on demand, a placeholder child is appended to it.
+            void Mark(const TreeIter &row) {
+                TreeIter p = row;
+                if (!gtk_tree_model_iter_has_child(store_, &p))
+                    store_.append_placeholder(p);
+            }
+            /// Returns false if the children of row are not loaded yet.
+            bool Loaded(const TreeIter &row) const {
+                TreeIter child;
+                return !placeholder(row, child);
+            }
+            /// Removes the children of row and marks it again, they are loaded again the next time the row is expanded.
+            void Reload(const TreeIter &row) {
+                TreeIter p = row, child;
+                GtkTreePath *path = gtk_tree_model_get_path(store_, &p);
+                gtk_tree_view_collapse_row(view_, path);
+                gtk_tree_path_free(path);
+                while (gtk_tree_model_iter_children(store_, &child, &p))
+                    store_.remove_row(child);
+                store_.append_placeholder(p);
+            }
     };
 
 
@@ -580,6 +2131,10 @@ This reference will keep pointing to the node pointed to by path, so long as it
             TreeRowReference(const TreeRowReference &src) {
                 obj_ = gtk_tree_row_reference_copy(src);
             }
+            TreeRowReference(TreeRowReference &&src) {
+                obj_ = src.obj_;
+                src.obj_ = NULL;
+            }
             /// Returns the model that the row reference is monitoring.
             TreeModel &Model() const {
                 if (TreeModel *m = dynamic_cast<TreeModel *>(
@@ -611,6 +2166,10 @@ This reference will keep pointing to the node pointed to by path, so long as it
                 obj_ = gtk_tree_row_reference_copy(right);
                 return *this;
             }
+            TreeRowReference &operator=(TreeRowReference &&right) {
+                std::swap(obj_, right.obj_);
+                return *this;
+            }
             TreeRowReference &operator=(const GtkTreeRowReference &right) {
                 gtk_tree_row_reference_free(obj_);
                 obj_ = gtk_tree_row_reference_copy(const_cast<GtkTreeRowReference *>(&right));
@@ -623,6 +2182,287 @@ This reference will keep pointing to the node pointed to by path, so long as it
             GtkTreeRowReference *obj_;
     };
 
+    /** Tracks many rows of a list model.
+
+Every TreeRowReference listens to the signals of the model on its own, so with thousands of references every inserted or deleted row costs as many updates. A RowTracker keeps all its rows in a single balanced tree that stores the distance of every row from the previous tracked row; an inserted or deleted row changes only the distance of the first row after it, so the tracker is updated in O(log n) whatever the number of tracked rows. A reordering of the model costs O(rows).
+
+Every tracked row is identified by a Handle, that stays valid until it's released with RowTracker::Release(), even after the row is deleted from the model.
+
+\example
+gtk::RowTracker bookmarks(store);
+gtk::RowTracker::Handle h = bookmarks.Track(1234);
+...
+gtk::TreeIter it;
+if (bookmarks.Resolve(h, it))
+    tv.Selection().Select(it);
+\endexample
+
+\note Only list models are supported, other models throw a std::runtime_error.
+    */
+    class RowTracker
+    {
+/// DOXYS_OFF
+            struct Node {
+                Node *left, *right, *parent;
+                int delta; // the position of the row minus the position of the previous node
+                int sum; // the sum of the deltas of the subtree
+                int size;
+                guint32 priority;
+                bool valid;
+            };
+/// DOXYS_ON
+        public:
+            /// Identifies a tracked row.
+            typedef Node *Handle;
+/// DOXYS_OFF
+        private:
+            GtkTreeModel *model_;
+            Node *root_;
+            std::vector<Node *> deleted_;
+            gulong inserted_, removed_, reordered_;
+            guint32 seed_;
+
+            RowTracker(const RowTracker &);
+            RowTracker &operator=(const RowTracker &);
+
+            static int size(const Node *n) { return n ? n->size : 0; }
+            static int sum(const Node *n) { return n ? n->sum : 0; }
+            static void update(Node *n) {
+                n->size = 1 + size(n->left) + size(n->right);
+                n->sum = n->delta + sum(n->left) + sum(n->right);
+                if (n->left) n->left->parent = n;
+                if (n->right) n->right->parent = n;
+            }
+            static Node *merge(Node *a, Node *b) {
+                if (!a) return b;
+                if (!b) return a;
+                if (a->priority > b->priority) {
+                    a->right = merge(a->right, b);
+                    update(a);
+                    a->parent = NULL;
+                    return a;
+                }
+                b->left = merge(a, b->left);
+                update(b);
+                b->parent = NULL;
+                return b;
+            }
+            // the first count nodes in a, the others in b
+            static void split(Node *t, int count, Node *&a, Node *&b) {
+                if (!t)
+                    a = b = NULL;
+                else if (size(t->left) >= count) {
+                    split(t->left, count, a, t->left);
+                    update(t);
+                    b = t;
+                }
+                else {
+                    split(t->right, count - size(t->left) - 1, t->right, b);
+                    update(t);
+                    a = t;
+                }
+                if (a) a->parent = NULL;
+                if (b) b->parent = NULL;
+            }
+            // adds d to the delta of the first node of the tree t
+            static void shift_first(Node *t, int d) {
+                Node *n = t;
+                while (n->left)
+                    n = n->left;
+                n->delta += d;
+                for (; n; n = n->parent)
+                    n->sum += d;
+            }
+            // the number of nodes with a position lower than pos
+            int rank_before(int pos) const {
+                int rank = 0, offset = 0;
+                for (Node *n = root_; n; ) {
+                    int p = offset + sum(n->left) + n->delta;
+                    if (p < pos) {
+                        rank += size(n->left) + 1;
+                        offset = p;
+                        n = n->right;
+                    }
+                    else
+                        n = n->left;
+                }
+                return rank;
+            }
+            static int position(const Node *x) {
+                int p = sum(x->left) + x->delta;
+                for (const Node *c = x, *a = x->parent; a; c = a, a = a->parent)
+                    if (a->right == c)
+                        p += sum(a->left) + a->delta;
+                return p;
+            }
+            static int rank(const Node *x) {
+                int r = size(x->left);
+                for (const Node *c = x, *a = x->parent; a; c = a, a = a->parent)
+                    if (a->right == c)
+                        r += size(a->left) + 1;
+                return r;
+            }
+            void invalidate(Node *n) {
+                if (!n)
+                    return;
+                invalidate(n->left);
+                invalidate(n->right);
+                n->left = n->right = n->parent = NULL;
+                n->valid = false;
+                // a deleted node has no delta, it keeps its index in deleted_
+                n->delta = deleted_.size();
+                deleted_.push_back(n);
+            }
+            static void collect(Node *n, int offset, std::vector<std::pair<int, Node *> > &nodes) {
+                if (!n)
+                    return;
+                collect(n->left, offset, nodes);
+                int p = offset + sum(n->left) + n->delta;
+                nodes.push_back(std::make_pair(p, n));
+                collect(n->right, p, nodes);
+            }
+            static void destroy(Node *n) {
+                if (!n)
+                    return;
+                destroy(n->left);
+                destroy(n->right);
+                delete n;
+            }
+            static void row_inserted(GtkTreeModel *, GtkTreePath *path, GtkTreeIter *, RowTracker *t) {
+                if (!t->root_)
+                    return;
+                Node *a, *b;
+                split(t->root_, t->rank_before(gtk_tree_path_get_indices(path)[0]), a, b);
+                if (b)
+                    shift_first(b, 1);
+                t->root_ = merge(a, b);
+            }
+            static void row_deleted(GtkTreeModel *, GtkTreePath *path, RowTracker *t) {
+                if (!t->root_)
+                    return;
+                int row = gtk_tree_path_get_indices(path)[0];
+                int first = t->rank_before(row), last = t->rank_before(row + 1);
+                Node *a, *b, *m, *c;
+                split(t->root_, first, a, b);
+                split(b, last - first, m, c);
+                // the next row moves up by one, its distance from the previous one includes the deleted nodes
+                if (c)
+                    shift_first(c, sum(m) - 1);
+                t->invalidate(m);
+                t->root_ = merge(a, c);
+            }
+            // new_order[new position] = old position
+            static void rows_reordered(GtkTreeModel *model, GtkTreePath *, GtkTreeIter *, gint *new_order, RowTracker *t) {
+                if (!t->root_)
+                    return;
+                std::vector<int> moved(gtk_tree_model_iter_n_children(model, NULL));
+                for (size_t i = 0; i < moved.size(); ++i)
+                    moved[new_order[i]] = i;
+
+                std::vector<std::pair<int, Node *> > nodes;
+                nodes.reserve(size(t->root_));
+                collect(t->root_, 0, nodes);
+                for (size_t i = 0; i < nodes.size(); ++i)
+                    nodes[i].first = moved[nodes[i].first];
+                std::stable_sort(nodes.begin(), nodes.end(), by_position);
+
+                t->root_ = NULL;
+                int previous = 0;
+                for (size_t i = 0; i < nodes.size(); ++i) {
+                    Node *n = nodes[i].second;
+                    n->left = n->right = NULL;
+                    n->delta = nodes[i].first - previous;
+                    previous = nodes[i].first;
+                    update(n);
+                    t->root_ = merge(t->root_, n);
+                }
+            }
+            static bool by_position(const std::pair<int, Node *> &a, const std::pair<int, Node *> &b) { return a.first < b.first; }
+/// DOXYS_ON
+        public:
+            /// Creates an empty tracker for the rows of model.
+            RowTracker(GtkTreeModel *model /**< a list model */) : model_(model), root_(NULL), seed_(0x9e3779b9) {
+                if (!(gtk_tree_model_get_flags(model) & GTK_TREE_MODEL_LIST_ONLY))
+                    throw std::runtime_error("RowTracker: only list models are supported");
+                g_object_ref(model_);
+                inserted_ = g_signal_connect(model_, "row-inserted", GCallback(row_inserted), this);
+                removed_ = g_signal_connect(model_, "row-deleted", GCallback(row_deleted), this);
+                reordered_ = g_signal_connect(model_, "rows-reordered", GCallback(rows_reordered), this);
+            }
+            /// Releases every handle.
+            ~RowTracker() {
+                g_signal_handler_disconnect(model_, inserted_);
+                g_signal_handler_disconnect(model_, removed_);
+                g_signal_handler_disconnect(model_, reordered_);
+                g_object_unref(model_);
+                destroy(root_);
+                for (size_t i = 0; i < deleted_.size(); ++i)
+                    delete deleted_[i];
+            }
+            /// Starts tracking the row at position row. \return the handle of the row.
+            Handle Track(int row) {
+                if (row < 0)
+                    throw std::runtime_error("RowTracker: invalid row");
+                Node *a, *b;
+                split(root_, rank_before(row), a, b);
+
+                Node *n = new Node;
+                n->left = n->right = n->parent = NULL;
+                n->delta = row - sum(a);
+                n->valid = true;
+                seed_ = seed_ * 1664525 + 1013904223;
+                n->priority = seed_;
+                update(n);
+                if (b)
+                    shift_first(b, -n->delta);
+                root_ = merge(merge(a, n), b);
+                return n;
+            }
+            /// Starts tracking the row pointed by it.
+            Handle Track(const TreeIter &it) {
+                GtkTreePath *path = gtk_tree_model_get_path(model_, const_cast<TreeIter *>(&it));
+                int row = path ? gtk_tree_path_get_indices(path)[0] : -1;
+                gtk_tree_path_free(path);
+                return Track(row);
+            }
+            /// Stops tracking a row and frees its handle.
+            void Release(Handle h) {
+                if (!h->valid) {
+                    deleted_[h->delta] = deleted_.back();
+                    deleted_[h->delta]->delta = h->delta;
+                    deleted_.pop_back();
+                    delete h;
+                    return;
+                }
+                Node *a, *b, *n, *c;
+                split(root_, rank(h), a, b);
+                split(b, 1, n, c);
+                if (c)
+                    shift_first(c, n->delta);
+                root_ = merge(a, c);
+                delete n;
+            }
+            /// Returns false if the row of h was deleted from the model.
+            bool Valid(Handle h) const { return h->valid; }
+            /// Returns the current position of the row of h, -1 if it was deleted.
+            int Position(Handle h) const { return h->valid ? position(h) : -1; }
+            /// Sets it to the row of h. \return false if the row was deleted.
+            bool Resolve(Handle h, TreeIter &it) const {
+                return h->valid && gtk_tree_model_iter_nth_child(model_, &it, NULL, position(h));
+            }
+            /// Fills rows with the sorted positions of the tracked rows still in the model, for instance for ListStore::RemoveRows().
+            void Rows(std::vector<int> &rows) const {
+                std::vector<std::pair<int, Node *> > nodes;
+                nodes.reserve(size(root_));
+                collect(root_, 0, nodes);
+                rows.clear();
+                for (size_t i = 0; i < nodes.size(); ++i)
+                    rows.push_back(nodes[i].first);
+            }
+            /// Returns the number of tracked rows still in the model.
+            int Size() const { return size(root_); }
+    };
+
 /** An object for rendering a single cell on a Drawable
 
 The CellRenderer is a base class of a set of objects used for rendering a cell to a Drawable. These objects are used primarily by the TreeView widget, though they aren't tied to them in any specific way. It is worth noting that CellRenderer is not a Widget and cannot be treated as such.
@@ -779,6 +2619,65 @@ Adjust how text is drawn using object properties. Object properties can be set g
         SortDescending = GTK_SORT_DESCENDING
     };
 
+    /** The output of a cell formatter, see TreeViewColumn::CellData().
+
+A CellFormat sets the properties of the renderer for the cell being drawn. Printf() formats into a buffer owned by the binding and reused for every cell, so no string is allocated to show a formatted number. Properties set with Foreground() and Background() are reset for the next cell if the formatter doesn't set them again. Any other property set with Set() stays on the renderer.
+    */
+    class CellFormat
+    {
+/// DOXYS_OFF
+            GtkCellRenderer *cell_;
+            char buf_[256];
+            bool fg_, bg_, had_fg_, had_bg_;
+        public:
+            CellFormat() : cell_(NULL), fg_(false), bg_(false), had_fg_(false), had_bg_(false) { buf_[0] = 0; }
+            void begin(GtkCellRenderer *cell) {
+                cell_ = cell;
+                had_fg_ = fg_;
+                had_bg_ = bg_;
+                fg_ = bg_ = false;
+            }
+            void end() {
+                if (had_fg_ && !fg_)
+                    g_object_set(cell_, "foreground-set", FALSE, NULL);
+                if (had_bg_ && !bg_)
+                    g_object_set(cell_, "cell-background-set", FALSE, NULL);
+            }
+/// DOXYS_ON
+            /// Returns the renderer of the cell.
+            GtkCellRenderer *Renderer() const { return cell_; }
+            /// Returns the reused buffer, of BufferSize() bytes.
+            char *Buffer() { return buf_; }
+            /// Returns the size of the buffer.
+            size_t BufferSize() const { return sizeof(buf_); }
+
+            /// Sets the "text" property of a text renderer.
+            void Text(const char *text) { g_object_set(cell_, "text", text, NULL); }
+            /// Formats the text in the reused buffer and sets it, see Text().
+            void Printf(const char *format, ...) G_GNUC_PRINTF(2, 3) {
+                va_list va;
+                va_start(va, format);
+                g_vsnprintf(buf_, sizeof(buf_), format, va);
+                va_end(va);
+                Text(buf_);
+            }
+            /// Sets the "markup" property of a text renderer.
+            void Markup(const char *markup) { g_object_set(cell_, "markup", markup, NULL); }
+            /// Sets the text color of a text renderer, like "red" or "#ff0000", for this cell only.
+            void Foreground(const char *color) {
+                g_object_set(cell_, "foreground", color, NULL);
+                fg_ = true;
+            }
+            /// Sets the background color of the cell, for this cell only.
+            void Background(const char *color) {
+                g_object_set(cell_, "cell-background", color, NULL);
+                bg_ = true;
+            }
+            /// Sets a property of the renderer, the value must have the type of the property (int, double, gboolean, const char *...).
+            template <typename V>
+            void Set(const char *property, V value) { g_object_set(cell_, property, value, NULL); }
+    };
+
     class TreeViewColumn : public Object
     {
         public:
@@ -902,6 +2801,133 @@ This is meaningful only if the TreeViewColumn::SizingMode is TreeViewColumn::Fix
             void AddAttribute(const CellRenderer &cell, const char *name, int column) {
                 gtk_tree_view_column_add_attribute(*this, cell, name, column);
             }
+            /** Sets the Pango attributes of every text renderer of the column.
+
+The attributes are applied to every cell of the column and are built once, unlike markup that is parsed every time a cell is drawn. Combined with TextPlain columns they style a column at no cost per cell. The renderers keep a reference to attrs.
+
+\example
+PangoAttrList *attrs = pango_attr_list_new();
+pango_attr_list_insert(attrs, pango_attr_weight_new(PANGO_WEIGHT_BOLD));
+tv.AddTextColumn("Name", 0, gtk::TextPlain)->TextAttributes(attrs);
+pango_attr_list_unref(attrs);
+\endexample
+            */
+            void TextAttributes(PangoAttrList *attrs /**< the attributes, NULL removes them */) {
+                GList *list = gtk_tree_view_column_get_cell_renderers(*this);
+                for (GList *l = list; l; l = l->next)
+                    if (GTK_IS_CELL_RENDERER_TEXT(l->data))
+                        g_object_set(l->data, "attributes", attrs, NULL);
+                g_list_free(list);
+            }
+
+            /** Formats the cells of renderer from the value of the column of the model.
+
+The formatter is called for every drawn cell with the value of the column, read as a V (see ColumnType, the value is converted if the column has another type), and sets the renderer properties through a CellFormat. No string column is needed to show formatted values and no string is allocated per cell. Setting a formatter replaces the previous cell data function of the renderer and clears its attributes: the "text" attribute set by TreeView::AddTextColumn() for instance would make GTK convert the value to a new string for every cell before the formatter runs.
+
+\example
+void MyApp::price(double value, gtk::CellFormat &out) {
+    out.Printf("%.2f EUR", value);
+    if (value < 0)
+        out.Foreground("red");
+}
+...
+column->CellData(renderer, 2, &MyApp::price, this);
+column->CellData<int>(renderer, 3, [](int size, gtk::CellFormat &out) { out.Printf("%d KB", size / 1024); });
+\endexample
+            */
+            template <typename V, typename T>
+            void CellData(const CellRenderer &cell /**< a renderer packed in the column */,
+                          int column /**< the column of the model */,
+                          void (T::*formatter)(V, CellFormat &) /**< the method called for every cell */,
+                          T *base /**< the object the method belongs to */) {
+                bind(cell, new ValueCbk<V, T>(column, formatter, base));
+            }
+            /// Formats the cells of renderer with a function object taking (V value, CellFormat &out), see CellData().
+            template <typename V, typename F>
+            void CellData(const CellRenderer &cell, int column, F formatter) {
+                bind(cell, new ValueFunctor<V, F>(column, formatter));
+            }
+            /// Formats the cells of renderer from the whole row, the method gets the model and the iterator of the row, see CellData().
+            template <typename T>
+            void CellData(const CellRenderer &cell, void (T::*formatter)(TreeModel &, const TreeIter &, CellFormat &), T *base) {
+                bind(cell, new RowCbk<T>(formatter, base));
+            }
+/// DOXYS_OFF
+        private:
+            struct AbstractCellData {
+                CellFormat out_;
+                virtual ~AbstractCellData() {}
+                virtual void format(GtkTreeModel *model, GtkTreeIter *it) = 0;
+
+                static void real_cbk(GtkTreeViewColumn *, GtkCellRenderer *cell, GtkTreeModel *model,
+                                     GtkTreeIter *it, gpointer data) {
+                    AbstractCellData *d = static_cast<AbstractCellData *>(data);
+                    d->out_.begin(cell);
+                    d->format(model, it);
+                    d->out_.end();
+                }
+                static void destroy(gpointer data) { delete static_cast<AbstractCellData *>(data); }
+            };
+            // reads the column as a V, converting it when the column has another type
+            template <typename V>
+            struct ValueCellData : public AbstractCellData {
+                int column_;
+                GValue value_, typed_;
+                bool warned_;
+                ValueCellData(int column) : column_(column), warned_(false) {
+                    memset(&value_, 0, sizeof(value_));
+                    memset(&typed_, 0, sizeof(typed_));
+                    g_value_init(&typed_, ColumnType<V>::Type());
+                }
+                ~ValueCellData() { g_value_unset(&typed_); }
+                virtual void call(V value) = 0;
+                void format(GtkTreeModel *model, GtkTreeIter *it) {
+                    gtk_tree_model_get_value(model, it, column_, &value_);
+                    if (G_VALUE_TYPE(&value_) == ColumnType<V>::Type())
+                        call(ColumnType<V>::Get(&value_));
+                    else {
+                        g_value_reset(&typed_);
+                        // a column that can't be converted is shown with the default value
+                        if (g_value_transform(&value_, &typed_))
+                            call(ColumnType<V>::Get(&typed_));
+                        else {
+                            if (!warned_)
+                                g_warning("CellData: cannot convert a %s column to %s", G_VALUE_TYPE_NAME(&value_), g_type_name(ColumnType<V>::Type()));
+                            warned_ = true;
+                            call(V());
+                        }
+                    }
+                    g_value_unset(&value_);
+                }
+            };
+            template <typename V, typename T>
+            struct ValueCbk : public ValueCellData<V> {
+                void (T::*fnc_)(V, CellFormat &);
+                T *obj_;
+                ValueCbk(int column, void (T::*fnc)(V, CellFormat &), T *obj) : ValueCellData<V>(column), fnc_(fnc), obj_(obj) {}
+                void call(V value) { (obj_->*fnc_)(value, this->out_); }
+            };
+            template <typename V, typename F>
+            struct ValueFunctor : public ValueCellData<V> {
+                F fnc_;
+                ValueFunctor(int column, F fnc) : ValueCellData<V>(column), fnc_(fnc) {}
+                void call(V value) { fnc_(value, this->out_); }
+            };
+            template <typename T>
+            struct RowCbk : public AbstractCellData {
+                void (T::*fnc_)(TreeModel &, const TreeIter &, CellFormat &);
+                T *obj_;
+                RowCbk(void (T::*fnc)(TreeModel &, const TreeIter &, CellFormat &), T *obj) : fnc_(fnc), obj_(obj) {}
+                void format(GtkTreeModel *model, GtkTreeIter *it) {
+                    if (TreeModel *m = dynamic_cast<TreeModel *>(Object::Find((GObject *)model)))
+                        (obj_->*fnc_)(*m, *it, out_);
+                }
+            };
+            void bind(const CellRenderer &cell, AbstractCellData *data) {
+                gtk_tree_view_column_clear_attributes(*this, cell);
+                gtk_tree_view_column_set_cell_data_func(*this, cell, AbstractCellData::real_cbk, data, AbstractCellData::destroy);
+            }
+/// DOXYS_ON
     };
 
 
@@ -929,6 +2955,7 @@ Several functions are available for converting between the different coordinate
             operator  GtkTreeView *() const { return GTK_TREE_VIEW(Obj()); }
 
             TreeView(GObject *obj) { Init(obj); }
+            static const char *text_property(TextMode mode) { return mode == TextPlain ? "text" : "markup"; }
 /// DOXYS_ON
             TreeView(const TreeModel &model) {
                 TreeModel &m = const_cast<TreeModel &>(model);
@@ -958,9 +2985,9 @@ Several functions are available for converting between the different coordinate
                 return dynamic_cast<TreeViewColumn *>(Object::Find((GObject *)c));
             }
 
-            TreeViewColumn *AddSortableTextColumn(const std::string &title, int id)
+            TreeViewColumn *AddSortableTextColumn(const std::string &title, int id, TextMode mode = TextMarkup)
             { 
-                if (TreeViewColumn *column = AddTextColumn(title, id)) {
+                if (TreeViewColumn *column = AddTextColumn(title, id, mode)) {
                     column->Clickable(true);
                     column->SortIndicator(true);
                     column->SortColumnId(id);
@@ -974,24 +3001,25 @@ Several functions are available for converting between the different coordinate
 
             /** Add a new, editable, text column to the TreeView.
 
-This API appends a new TreeViewColumn to the TreeView, the column is in text format with Pango markup enabled and can be made editable on cell bases specifying an edit_id boolean column of the associated TreeModel to select if a cell is editable or not or, if you don't specify edit_id, all the cells of this column will be editable.
+This API appends a new TreeViewColumn to the TreeView, the column is in text format with Pango markup enabled (unless mode is TextPlain) and can be made editable on cell bases specifying an edit_id boolean column of the associated TreeModel to select if a cell is editable or not or, if you don't specify edit_id, all the cells of this column will be editable.
 \return a pointer to the newly created TreeViewColumn or NULL if some problem occurred.
 */
             TreeViewColumn *AddEditableColumn(const std::string &title /**< Title for the column */, 
                                               int id /**< The ID of the column where to retrieve this column text in the associated TreeModel */, 
-                                              int edit_id = -1 /**< The optional ID of the column in the TreeModel associated to this TreeView that defines if the text is editable or not on cell basis, if not specified defaults to -1 that means that every cell of this column is editable. */) {
+                                              int edit_id = -1 /**< The optional ID of the column in the TreeModel associated to this TreeView that defines if the text is editable or not on cell basis, if not specified defaults to -1 that means that every cell of this column is editable. */,
+                                              TextMode mode = TextMarkup /**< TextPlain binds the "text" property instead of "markup" */) {
                 CellRendererText r;
                 int col;
 
                 if (edit_id != -1) {
                     col = gtk_tree_view_insert_column_with_attributes(*this, -1,
-                            title.c_str(), r, "markup", id,
+                            title.c_str(), r, text_property(mode), id,
                             "editable", edit_id,
                             NULL);
                 }
                 else {
                     col = gtk_tree_view_insert_column_with_attributes(*this, -1,
-                            title.c_str(), r, "markup", id,
+                            title.c_str(), r, text_property(mode), id,
                             NULL);
                     r.Set("editable", true);
                 }
@@ -999,10 +3027,19 @@ This API appends a new TreeViewColumn to the TreeView, the column is in text for
                 return Get(col - 1);
             }
 
-            TreeViewColumn *AddTextColumn(const std::string &title, int id) {
+            /// Adds an editable text column where every cell is editable, see AddEditableColumn().
+            TreeViewColumn *AddEditableColumn(const std::string &title, int id, TextMode mode) {
+                return AddEditableColumn(title, id, -1, mode);
+            }
+
+            /** Adds a text column showing the strings of the column id of the model.
+
+By default the strings are Pango markup. With TextPlain they are bound to the "text" property and no markup is parsed when the cells are drawn, which is much faster on large views.
+            */
+            TreeViewColumn *AddTextColumn(const std::string &title, int id, TextMode mode = TextMarkup) {
                 CellRendererText r;
                 int col = gtk_tree_view_insert_column_with_attributes(*this, -1,
-                        title.c_str(), r, "markup", id,
+                        title.c_str(), r, text_property(mode), id,
                         NULL);
 
                 return Get(col - 1);
@@ -1087,7 +3124,7 @@ This API appends a new TreeViewColumn to the TreeView, the column is in text for
                 return Get(col -1);
             }
 
-            TreeViewColumn *AddPixTextColumn(const std::string &title, int textid, int pixid) {
+            TreeViewColumn *AddPixTextColumn(const std::string &title, int textid, int pixid, TextMode mode = TextMarkup) {
                 CellRendererPixbuf r1;
                 CellRendererText r2;
 
@@ -1097,7 +3134,7 @@ This API appends a new TreeViewColumn to the TreeView, the column is in text for
                 col->PackStart(r1, false);
                 col->PackStart(r2);
                 col->AddAttribute(r1, "pixbuf", pixid);
-                col->AddAttribute(r2, "markup", textid);
+                col->AddAttribute(r2, text_property(mode), textid);
                 Append(*col);
 
                 return col;
@@ -1194,8 +3231,7 @@ This API appends a new TreeViewColumn to the TreeView, the column is in text for
                 GtkTreeViewColumn *cc = NULL;
                 if(gtk_tree_view_get_path_at_pos(*this, position.x, position.y,
                             &p, &cc, NULL, NULL)) {
-                    path = *p;
-                    gtk_tree_path_free(p);
+                    path = TreePath(p);
                     if (c) {
                         if (cc) 
                             *c = dynamic_cast<TreeViewColumn*>(Object::Find((GObject*)cc));
@@ -1340,6 +3376,208 @@ This API appends a new TreeViewColumn to the TreeView, the column is in text for
         return result;
     }
 
+    /** Measures the columns of a TreeView on a sample of the rows.
+
+A column with the TreeViewColumn::Autosize sizing, or TreeView::Autosize(), measures every row of the model, a view with a few hundred thousand rows spends seconds in its first layout. A ColumnSizer measures only a sample of the top level rows, evenly spread on the model, sets every column to TreeViewColumn::Fixed with the measured width, and enables TreeView::FixedHeightMode() when the sample shows that every row has the same height, so GTK doesn't measure the rows either.
+
+The measured widths are cached in the columns: Measure() only measures the columns added since the last call, after the data of some columns changed Refresh() measures them again.
+
+\example
+tv.Model(store);
+gtk::ColumnSizer sizer(tv, 200);
+sizer.Measure();
+...
+store.Set(it, 2, "a much longer description", -1);
+sizer.Refresh(*tv.Get(2));
+\endexample
+
+\note The rows out of the sample are not measured, a column may be narrower than its longest cell. Text renderers that wrap their text (with a "wrap-width") never enable the fixed height mode.
+*/
+    class ColumnSizer
+    {
+/// DOXYS_OFF
+        private:
+            struct Sizes {
+                int width, min_height, max_height;
+                bool wraps;
+            };
+            GtkTreeView *view_;
+            int sample_;
+
+            static Sizes *cached(GtkTreeViewColumn *col) {
+                return static_cast<Sizes *>(g_object_get_data(G_OBJECT(col), "oogtk-measure"));
+            }
+            static void destroy(gpointer m) { delete static_cast<Sizes *>(m); }
+
+            // the rows of the sample, all the rows when they are less than the sample
+            void sample_rows(GtkTreeModel *model, std::vector<GtkTreeIter> &rows) const {
+                int count = gtk_tree_model_iter_n_children(model, NULL);
+                int n = std::min(count, sample_);
+                GtkTreeIter it;
+
+                rows.clear();
+                rows.reserve(n);
+                if (n == count) {
+                    if (gtk_tree_model_get_iter_first(model, &it)) {
+                        do rows.push_back(it); while (gtk_tree_model_iter_next(model, &it));
+                    }
+                }
+                else if (n == 1) {
+                    if (gtk_tree_model_iter_nth_child(model, &it, NULL, 0))
+                        rows.push_back(it);
+                }
+                else {
+                    for (int i = 0; i < n; ++i)
+                        if (gtk_tree_model_iter_nth_child(model, &it, NULL, (gint)((gint64)i * (count - 1) / (n - 1))))
+                            rows.push_back(it);
+                }
+            }
+            void measure(GtkTreeViewColumn *col, GtkTreeModel *model, const std::vector<GtkTreeIter> &rows) {
+                Sizes *m = cached(col);
+                if (!m) {
+                    m = new Sizes;
+                    g_object_set_data_full(G_OBJECT(col), "oogtk-measure", m, destroy);
+                }
+                m->width = 0;
+                m->min_height = G_MAXINT;
+                m->max_height = 0;
+                m->wraps = false;
+
+                GList *cells = gtk_tree_view_column_get_cell_renderers(col);
+                for (GList *l = cells; l; l = l->next) {
+                    if (GTK_IS_CELL_RENDERER_TEXT(l->data)) {
+                        gint wrap = -1;
+                        g_object_get(l->data, "wrap-width", &wrap, NULL);
+                        m->wraps |= wrap > 0;
+                    }
+                }
+                g_list_free(cells);
+
+                bool expander = gtk_tree_view_get_expander_column(view_) == col &&
+                                gtk_tree_view_get_show_expanders(view_) &&
+                                !(gtk_tree_model_get_flags(model) & GTK_TREE_MODEL_LIST_ONLY);
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    gint w = 0, h = 0;
+                    GtkTreeIter it = rows[i];
+                    gtk_tree_view_column_cell_set_cell_data(col, model, &it, expander && gtk_tree_model_iter_has_child(model, &it), FALSE);
+                    gtk_tree_view_column_cell_get_size(col, NULL, NULL, NULL, &w, &h);
+                    m->width = std::max(m->width, (int)w);
+                    m->min_height = std::min(m->min_height, (int)h);
+                    m->max_height = std::max(m->max_height, (int)h);
+                }
+                if (m->min_height > m->max_height)
+                    m->min_height = m->max_height;
+
+                // the spacing GTK adds to every cell, and the expander of the top level rows
+                gint separator = 0, expander_size = 0;
+                gtk_widget_style_get(GTK_WIDGET(view_), "horizontal-separator", &separator,
+                                     "expander-size", &expander_size, NULL);
+                m->width += separator;
+                if (expander)
+                    m->width += expander_size;
+
+                // the header is never narrower than its title, the button is a public field in GTK2
+                if (gtk_tree_view_get_headers_visible(view_) && col->button) {
+                    GtkRequisition req;
+                    gtk_widget_size_request(col->button, &req);
+                    m->width = std::max(m->width, (int)req.width);
+                }
+                apply(col, m);
+            }
+            static void apply(GtkTreeViewColumn *col, const Sizes *m) {
+                if (gtk_tree_view_column_get_sizing(col) != GTK_TREE_VIEW_COLUMN_FIXED)
+                    gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
+                if (m->width > 0 && gtk_tree_view_column_get_fixed_width(col) != m->width)
+                    gtk_tree_view_column_set_fixed_width(col, m->width);
+            }
+            // the rows have the same height if the tallest column of a row is the tallest in every row
+            void update_height_mode() {
+                GList *columns = gtk_tree_view_get_columns(view_);
+                int floor = 0, ceiling = 0;
+                bool fixed = columns != NULL;
+
+                for (GList *l = columns; l; l = l->next) {
+                    GtkTreeViewColumn *col = GTK_TREE_VIEW_COLUMN(l->data);
+                    const Sizes *m = cached(col);
+                    if (!m || m->wraps || gtk_tree_view_column_get_sizing(col) != GTK_TREE_VIEW_COLUMN_FIXED) {
+                        fixed = false;
+                        break;
+                    }
+                    if (!gtk_tree_view_column_get_visible(col))
+                        continue;
+                    floor = std::max(floor, m->min_height);
+                    ceiling = std::max(ceiling, m->max_height);
+                }
+                g_list_free(columns);
+
+                fixed = fixed && ceiling > 0 && floor == ceiling;
+                if (fixed != (bool)gtk_tree_view_get_fixed_height_mode(view_))
+                    gtk_tree_view_set_fixed_height_mode(view_, fixed);
+            }
+            void measure(const std::vector<GtkTreeViewColumn *> &cols) {
+                GtkTreeModel *model = gtk_tree_view_get_model(view_);
+                if (!model)
+                    return;
+
+                std::vector<GtkTreeIter> rows;
+                sample_rows(model, rows);
+                for (size_t i = 0; i < cols.size(); ++i)
+                    measure(cols[i], model, rows);
+                update_height_mode();
+            }
+            void columns(std::vector<GtkTreeViewColumn *> &cols, bool all) const {
+                GList *list = gtk_tree_view_get_columns(view_);
+                for (GList *l = list; l; l = l->next) {
+                    GtkTreeViewColumn *col = GTK_TREE_VIEW_COLUMN(l->data);
+                    if (all || !cached(col))
+                        cols.push_back(col);
+                    else
+                        apply(col, cached(col));
+                }
+                g_list_free(list);
+            }
+/// DOXYS_ON
+        public:
+            /// Creates a sizer for the columns of view, measuring at most sample rows.
+            ColumnSizer(TreeView &view, int sample = 100) : view_(view), sample_(std::max(sample, 1)) {}
+
+            /// Measures the columns without a cached width, applies the cached widths to the others and updates the fixed height mode of the view.
+            void Measure() {
+                std::vector<GtkTreeViewColumn *> cols;
+                columns(cols, false);
+                measure(cols);
+            }
+            /// Measures again the column, after its data changed.
+            void Refresh(TreeViewColumn &column) {
+                measure(std::vector<GtkTreeViewColumn *>(1, column));
+            }
+            /// Measures again the columns, the model is sampled only once for all the columns.
+            void Refresh(const ColumnList &cols) {
+                std::vector<GtkTreeViewColumn *> v;
+                for (ColumnList::const_iterator it = cols.begin(); it != cols.end(); ++it)
+                    v.push_back(*(*it));
+                measure(v);
+            }
+            /// Measures again every column of the view, for instance after the model was replaced.
+            void RefreshAll() {
+                std::vector<GtkTreeViewColumn *> cols;
+                columns(cols, true);
+                measure(cols);
+            }
+            /// Returns the cached width of column, -1 if it was never measured.
+            int Width(const TreeViewColumn &column) const {
+                const Sizes *m = cached(column);
+                return m ? m->width : -1;
+            }
+            /// Returns true if the sampled rows have the same height, that is if the fixed height mode was enabled.
+            bool FixedHeight() const { return gtk_tree_view_get_fixed_height_mode(view_); }
+
+            /// Returns the number of rows measured for every column.
+            int Sample() const { return sample_; }
+            /// Sets the number of rows measured for every column, the cached widths are kept until the next Refresh().
+            void Sample(int rows) { sample_ = std::max(rows, 1); }
+    };
+
     /** CellLayout is an interface to be implemented by all objects which want to provide a TreeViewColumn-like API for packing cells, setting attributes and data funcs.
 
 One of the notable features provided by implementations of CellLayout are attributes. Attributes let you set the properties in flexible ways. They can just be set to constant values like regular properties. But they can also be mapped to a column of the underlying tree model with CellLayout::Attributes(), which means that the value of the attribute can change from cell to cell as they are rendered by the cell renderer. Finally, it is possible to specify a function with CellLayout::CellDataFunc() that is called to determine the value of the attribute for each cell that is rendered.
@@ -1500,11 +3738,12 @@ This function is mostly intended for use by accessibility technologies; applicat
             bool FocusOnClick() const { return gtk_combo_box_get_focus_on_click(*this); }
             void FocusOnClick(bool flag) { gtk_combo_box_set_focus_on_click(*this, flag); }
 
-            void AddTextColumn(int id, bool expand = true) {
+            void AddTextColumn(int id, bool expand = true, TextMode mode = TextMarkup) {
                 CellRendererText txt;
                 PackStart(txt, expand);
-                AddAttribute(txt, "markup", id);
+                AddAttribute(txt, mode == TextPlain ? "text" : "markup", id);
             }
+            void AddTextColumn(int id, TextMode mode, bool expand = true) { AddTextColumn(id, expand, mode); }
 /** Returns the wrap width which is used to determine the number of columns for the popup menu. If the wrap width is larger than 1, the combo box is in table mode. */
             int WrapWidth() const { return gtk_combo_box_get_wrap_width(*this); }
 /** Sets the wrap width of the object to be width. The wrap width is basically the preferred number of columns when you want the popup to be layed out in a table.
@@ -1584,6 +3823,18 @@ If the ComboBoxText contains an entry (via the 'has-entry' property), its conten
                 gtk_combo_box_text_remove(*this, row); 
 #endif
             }
+/** Replaces the items of the combo with strings.
+
+The strings are inserted in a new list that isn't attached to any widget, then the list replaces the model of the combo at once, so the combo and its popup are updated once rather than once per item as with a loop of ComboBoxText::Append(). The active item is reset. To show the same long list in many combos share a StringList with ComboBox::Model() instead.
+*/
+            void Assign(const std::vector<std::string> &strings) {
+                GtkListStore *store = gtk_list_store_new(1, G_TYPE_STRING);
+                GtkTreeIter it;
+                for (size_t i = 0; i < strings.size(); ++i)
+                    gtk_list_store_insert_with_values(store, &it, -1, 0, strings[i].c_str(), -1);
+                gtk_combo_box_set_model(GTK_COMBO_BOX(Obj()), GTK_TREE_MODEL(store));
+                g_object_unref(store);
+            }
 
             std::string ActiveText() { 
                 std::string res;
@@ -1747,8 +3998,7 @@ IconView provides an alternative view on a list model. It displays the model as
            */           
             bool PathAt(TreePath &path, const Point &position) {
                 if(GtkTreePath *p = gtk_icon_view_get_path_at_pos(*this, position.x, position.y)) {
-                    path = *p;
-                    gtk_tree_path_free(p);
+                    path = TreePath(p);
                     return true;
                 }
                 return false;                
@@ -1784,8 +4034,7 @@ This function is often followed by Widget::GrabFocus (on the icon_view) in order
                 gboolean rc = gtk_icon_view_get_cursor(*this, &p, &c);
                 if (rc  == FALSE || p == NULL) 
                     return false;
-                path = *p;
-                gtk_tree_path_free(p);
+                path = TreePath(p);
                 return true;
             }
             /// Sets the selection mode of the icon_view.
@@ -1873,11 +4122,9 @@ This function only works if the model is set, and path is a valid row on the mod
                 GtkTreePath *s, *e;
                 if (gtk_icon_view_get_visible_range(*this, &s, &e)) {
                     if (s) {
-                        start_path = *s;
-                        gtk_tree_path_free(s);
+                        start_path = TreePath(s);
                         if (e) {
-                            end_path = *e;
-                            gtk_tree_path_free(e);
+                            end_path = TreePath(e);
                             return true;
                         }
                     }
@@ -0,0 +1,231 @@
+#ifndef OOTYPED_H
+#define OOTYPED_H
+
+/**
+ * GG
+ * ListStore and TreeStore with the column types fixed at compile time.
+ * The ColumnType mapping used by the typed stores is in ootree.h.
+ */
+
+#include "ootree.h"
+#include <tuple>
+#include <type_traits>
+#include <string.h>
+
+namespace gtk {
+
+/// DOXYS_OFF
+    // the GValues of a whole row, on the stack and without varargs
+    template <typename... Cols>
+    class TypedRow {
+            GValue values_[sizeof...(Cols)];
+            gint columns_[sizeof...(Cols)];
+
+            template <int I>
+            void fill() {}
+            template <int I, typename T, typename... Rest>
+            void fill(const T &value, const Rest &... rest) {
+                g_value_init(&values_[I], ColumnType<T>::Type());
+                ColumnType<T>::Set(&values_[I], value);
+                columns_[I] = I;
+                fill<I + 1>(rest...);
+            }
+            TypedRow(const TypedRow &);
+            TypedRow &operator=(const TypedRow &);
+        public:
+            TypedRow(const Cols &... values) {
+                memset(values_, 0, sizeof(values_));
+                fill<0>(values...);
+            }
+            ~TypedRow() {
+                for (size_t i = 0; i < sizeof...(Cols); ++i)
+                    g_value_unset(&values_[i]);
+            }
+            static void Types(GType *types) {
+                GType t[] = { ColumnType<Cols>::Type()... };
+                for (size_t i = 0; i < sizeof...(Cols); ++i)
+                    types[i] = t[i];
+            }
+            GValue *Values() { return values_; }
+            gint *Columns() { return columns_; }
+            int Size() const { return sizeof...(Cols); }
+    };
+
+    // true if one of the types is const char *, that doesn't outlive the GValue it's read from
+    template <typename... T>
+    struct BorrowedString : std::false_type {};
+    template <typename T, typename... Rest>
+    struct BorrowedString<T, Rest...> :
+        std::integral_constant<bool, std::is_same<T, const char *>::value || BorrowedString<Rest...>::value> {};
+
+    // the typed accessors shared by TypedListStore and TypedTreeStore
+    template <typename Store, typename... Cols>
+    class TypedStore : public Store
+    {
+            static_assert(sizeof...(Cols) > 0, "a store needs at least a column");
+            static_assert(!BorrowedString<Cols...>::value, "a const char * column would be read from a freed GValue, use std::string");
+
+            static GType *types() {
+                static GType t[sizeof...(Cols)];
+                TypedRow<Cols...>::Types(t);
+                return t;
+            }
+            static void set_value(GtkListStore *s, const TreeIter &it, int col, GValue *v) {
+                gtk_list_store_set_value(s, const_cast<TreeIter *>(&it), col, v);
+            }
+            static void set_value(GtkTreeStore *s, const TreeIter &it, int col, GValue *v) {
+                gtk_tree_store_set_value(s, const_cast<TreeIter *>(&it), col, v);
+            }
+            static void set_values(GtkListStore *s, const TreeIter &it, TypedRow<Cols...> &row) {
+                gtk_list_store_set_valuesv(s, const_cast<TreeIter *>(&it), row.Columns(), row.Values(), row.Size());
+            }
+            static void set_values(GtkTreeStore *s, const TreeIter &it, TypedRow<Cols...> &row) {
+                gtk_tree_store_set_valuesv(s, const_cast<TreeIter *>(&it), row.Columns(), row.Values(), row.Size());
+            }
+        protected:
+            TypedStore() : Store((int)sizeof...(Cols), types()) {}
+            TypedStore(GObject *o) : Store(o) {}
+/// DOXYS_ON
+        public:
+            /// The number of columns of the store.
+            static constexpr int Columns = sizeof...(Cols);
+            /// The C++ type of the column N.
+            template <int N>
+            struct Column {
+                static_assert(N >= 0 && N < (int)sizeof...(Cols), "column index out of range");
+                typedef typename std::tuple_element<N, std::tuple<Cols...> >::type Type;
+            };
+
+            /// Returns the value of the column N of the row at it.
+            template <int N>
+            typename Column<N>::Type Get(const TreeIter &it) {
+                typedef typename Column<N>::Type T;
+                GValue v;
+                memset(&v, 0, sizeof(v));
+                gtk_tree_model_get_value(*this, const_cast<TreeIter *>(&it), N, &v);
+                T result = ColumnType<T>::Get(&v);
+                g_value_unset(&v);
+                return result;
+            }
+            /// Sets the value of the column N of the row at it.
+            template <int N>
+            void Set(const TreeIter &it, const typename Column<N>::Type &value) {
+                typedef typename Column<N>::Type T;
+                GValue v;
+                memset(&v, 0, sizeof(v));
+                g_value_init(&v, ColumnType<T>::Type());
+                ColumnType<T>::Set(&v, value);
+                set_value(*this, it, N, &v);
+                g_value_unset(&v);
+            }
+            /// Sets all the columns of the row at it with a single row-changed signal.
+            void SetRow(const TreeIter &it, const Cols &... values) {
+                TypedRow<Cols...> row(values...);
+                set_values(*this, it, row);
+            }
+
+            /** A row of a typed store.
+
+A Row holds the store and an iterator, it's valid as long as the iterator is.
+
+\example
+MyStore::Row r = store[it];
+r.Set<Name>("gtk");
+std::cerr << r.Get<Size>() << "\n";
+\endexample
+            */
+            class Row {
+                    TypedStore &store_;
+                    TreeIter it_;
+                public:
+                    Row(TypedStore &store, const TreeIter &it) : store_(store), it_(it) {}
+
+                    template <int N>
+                    typename Column<N>::Type Get() const { return store_.template Get<N>(it_); }
+                    template <int N>
+                    void Set(const typename Column<N>::Type &value) { store_.template Set<N>(it_, value); }
+                    /// Sets all the columns of the row.
+                    void Assign(const Cols &... values) { store_.SetRow(it_, values...); }
+                    /// Returns the iterator of the row.
+                    const TreeIter &Iter() const { return it_; }
+            };
+            /// Returns the row at it.
+            Row operator[](const TreeIter &it) { return Row(*this, it); }
+    };
+
+/** A ListStore with the column types fixed at compile time.
+
+The columns are given as C++ types, that are mapped to GTypes by ColumnType. The values of a row are checked at compile time and stored without varargs, so a type mismatch between the code and the store doesn't compile. Columns are referenced by their index, an enum keeps the code readable.
+
+\example
+enum { Name, Size, Visible };
+typedef gtk::TypedListStore<std::string, int, bool> FileStore;
+
+FileStore store;
+gtk::TreeIter it = store.Append("README", 1024, true);
+store.Set<Size>(it, 2048);
+int size = store.Get<Size>(it);
+tv.AddTextColumn("Name", Name);
+\endexample
+
+\sa TypedTreeStore
+*/
+    template <typename... Cols>
+    class TypedListStore : public TypedStore<ListStore, Cols...>
+    {
+            typedef TypedStore<ListStore, Cols...> Base;
+        public:
+            /// Creates a new store with the column types Cols.
+            TypedListStore() {}
+/// DOXYS_OFF
+            TypedListStore(GObject *o) : Base(o) {}
+/// DOXYS_ON
+            /// Appends a row with the given values, with a single row-inserted signal.
+            TreeIter Append(const Cols &... values) { return Insert(-1, values...); }
+            /// Prepends a row with the given values.
+            TreeIter Prepend(const Cols &... values) { return Insert(0, values...); }
+            /// Inserts a row with the given values at position, -1 appends it.
+            TreeIter Insert(int position, const Cols &... values) {
+                TypedRow<Cols...> row(values...);
+                TreeIter it;
+                gtk_list_store_insert_with_valuesv(*this, &it, position, row.Columns(), row.Values(), row.Size());
+                return it;
+            }
+    };
+
+/** A TreeStore with the column types fixed at compile time.
+
+See TypedListStore, the rows are added at the top level or as children of a parent row.
+*/
+    template <typename... Cols>
+    class TypedTreeStore : public TypedStore<TreeStore, Cols...>
+    {
+            typedef TypedStore<TreeStore, Cols...> Base;
+        public:
+            /// Creates a new store with the column types Cols.
+            TypedTreeStore() {}
+/// DOXYS_OFF
+            TypedTreeStore(GObject *o) : Base(o) {}
+/// DOXYS_ON
+            /// Appends a row at the top level.
+            TreeIter Append(const Cols &... values) { return insert(NULL, -1, values...); }
+            /// Appends a child to parent.
+            TreeIter Append(const TreeIter &parent, const Cols &... values) { return insert(&parent, -1, values...); }
+            /// Inserts a child of parent at position, -1 appends it.
+            TreeIter Insert(const TreeIter &parent, int position, const Cols &... values) {
+                return insert(&parent, position, values...);
+            }
+/// DOXYS_OFF
+        private:
+            TreeIter insert(const TreeIter *parent, int position, const Cols &... values) {
+                TypedRow<Cols...> row(values...);
+                TreeIter it;
+                gtk_tree_store_insert_with_valuesv(*this, &it, const_cast<TreeIter *>(parent), position,
+                                                   row.Columns(), row.Values(), row.Size());
+                return it;
+            }
+/// DOXYS_ON
+    };
+}
+
+#endif
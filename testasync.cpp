@@ -0,0 +1,69 @@
+// background loading of a big model, the window stays responsive while the rows are attached
+#include "ooasync.h"
+#include <sstream>
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::ListStore list;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::ProgressBar bar;
+    gtk::AsyncListLoader *loader;
+public:
+    MyApp() : win("Test AsyncListLoader"),
+              list(make_vector(G_TYPE_INT)(G_TYPE_STRING)(G_TYPE_DOUBLE)), tv(list) {
+        win.Child(box);
+        win.Border(8);
+        win.DefaultSize(400, 500);
+        box.PackStart(sw);
+        box.PackEnd(bar, false);
+        box.Spacing(4);
+        sw.Child(tv);
+        win.OnDelete(&MyApp::quit, this, true);
+        tv.AddTextColumn("Id", 0);
+        tv.AddTextColumn("Name", 1);
+        tv.AddTextColumn("Value", 2);
+        bar.Text("Loading...");
+        win.ShowAll();
+
+        loader = new gtk::AsyncListLoader(list, &MyApp::fill, this);
+        loader->OnProgress(&MyApp::progress, this);
+    }
+    ~MyApp() { delete loader; }
+
+    // worker thread, no GTK calls here, it stops early if the window is closed while filling
+    void fill(gtk::RowBuffer &rows, gtk::AsyncListLoader &l) {
+        for (int i = 0; i < 200000 && l.Running(); ++i) {
+            std::ostringstream os;
+            os << "Row number " << i;
+            rows.AddRow();
+            rows.Set(0, i);
+            rows.Set(1, os.str());
+            rows.Set(2, i * 0.5);
+        }
+    }
+    void progress(gtk::AsyncLoader &l) {
+        if (!l.Finished()) {
+            bar.Fraction(double(l.Done()) / l.Total());
+            return;
+        }
+        if (!l.Error().empty())
+            bar.Text("Error: " + l.Error());
+        else {
+            std::ostringstream os;
+            os << l.Done() << " rows loaded";
+            bar.Text(os.str());
+            bar.Fraction(1.0);
+        }
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    gtk::Application::ThreadInit();
+    MyApp app;
+    app.Run();
+}
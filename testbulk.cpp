@@ -0,0 +1,78 @@
+// compares the insertion of rows one by one in a sorted ListStore with ListStore::AppendRows()
+#include "oogtk.h"
+
+#define ROWS 20000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::ListStore store;
+    gtk::TreeStore tree;
+    gtk::TreeView tv, ttv;
+    gtk::ScrolledWindow sw, tsw;
+public:
+    MyApp() : win("Test bulk insertion"),
+              store(make_vector(G_TYPE_INT)(G_TYPE_STRING)),
+              tree(make_vector(G_TYPE_STRING)(G_TYPE_INT)) {
+        char buf[32];
+
+        tv.AddTextColumn("Id", 0);
+        tv.AddTextColumn("Name", 1);
+        tv.Model(store);
+        // sorted on the name column, every insertion moves the new row in place
+        gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE((GtkListStore *)store), 1, GTK_SORT_ASCENDING);
+
+        gint64 start = g_get_monotonic_time();
+        for (int i = 0; i < ROWS; ++i) {
+            g_snprintf(buf, sizeof(buf), "row %08d", (i * 7919) % ROWS);
+            store.AddTail(0, i, 1, buf, -1);
+        }
+        gint64 single = g_get_monotonic_time() - start;
+
+        store.Clear();
+        start = g_get_monotonic_time();
+        store.AppendRows(ROWS, &MyApp::fill, this, tv);
+        gint64 bulk = g_get_monotonic_time() - start;
+
+        std::cerr << ROWS << " rows added one by one in " << single / 1000 << "ms, in bulk in "
+                  << bulk / 1000 << "ms\n";
+
+        ttv.AddTextColumn("Node", 0);
+        ttv.AddTextColumn("Value", 1);
+        ttv.Model(tree);
+        tree.AppendChildren(10, &MyApp::fill_node, this, ttv);
+        gtk::TreeIter it = tree.First();
+        do {
+            tree.AppendChildren(it, 100, &MyApp::fill_node, this, ttv);
+        } while (tree.Next(it));
+
+        sw.Child(tv);
+        tsw.Child(ttv);
+        box.PackStart(sw);
+        box.PackStart(tsw);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    void fill(int row, gtk::RowValues &values) {
+        char buf[32];
+        g_snprintf(buf, sizeof(buf), "row %08d", (row * 7919) % ROWS);
+        values.Set(0, row);
+        values.Set(1, buf);
+    }
+    void fill_node(int row, gtk::RowValues &values) {
+        char buf[32];
+        g_snprintf(buf, sizeof(buf), "node %d", row);
+        values.Set(0, buf);
+        values.Set(1, row * row);
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,107 @@
+// draws a sparkline and a bar in the cells of a TreeView with two CustomCellRenderer
+#include "oogtk.h"
+#include "oocellrenderer.h"
+#include <vector>
+#include <math.h>
+
+#define ROWS 200
+#define SAMPLES 40
+
+typedef std::vector<double> Series;
+
+// the history of a row, a G_TYPE_POINTER column points to a Series
+class Sparkline : public gtk::CustomCellRenderer
+{
+    void GetSize(GtkWidget *, int &width, int &height) { width = 120; height = 16; }
+    void Render(cairo::Context &cr, const gtk::Rect &area) {
+        Series *s = static_cast<Series *>(Value<gpointer>());
+        if (!s || s->size() < 2)
+            return;
+        double step = (double)area.width / (s->size() - 1);
+        for (size_t i = 0; i < s->size(); ++i) {
+            double y = area.y + area.height * (1.0 - (*s)[i]);
+            if (i)
+                cr.line_to(area.x + i * step, y);
+            else
+                cr.move_to(area.x, y);
+        }
+        cr.line_width(1.0);
+        cr.source_rgb(Selected() ? "#ffffff" : "#204a87");
+        cr.stroke();
+    }
+};
+
+// the last value of a row, from 0 to 1
+class Bar : public gtk::CustomCellRenderer
+{
+    void GetSize(GtkWidget *, int &width, int &height) { width = 80; height = 12; }
+    void Render(cairo::Context &cr, const gtk::Rect &area) {
+        double v = Value<double>();
+        cr.rectangle(area.x, area.y, area.width * v, area.height);
+        if (Selected())
+            cr.source_rgb("#ffffff");
+        else
+            cr.source_rgb(v > 0.8 ? "#cc0000" : "#73d216");
+        cr.fill();
+    }
+};
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::TreeViewColumn history, level;
+    Sparkline spark;
+    Bar bar;
+    std::vector<Series> series;
+    int tick;
+public:
+    MyApp() : win("Test CustomCellRenderer"), store(make_vector(G_TYPE_STRING)(G_TYPE_DOUBLE)(G_TYPE_POINTER)),
+              series(ROWS, Series(SAMPLES, 0.0)), tick(0) {
+        for (int i = 0; i < ROWS; ++i) {
+            std::ostringstream os;
+            os << "Sensor " << i;
+            store.AddTail(0, os.str().c_str(), 1, 0.0, 2, &series[i], -1);
+        }
+        tv.AddTextColumn("Name", 0);
+
+        history.Title("History");
+        history.PackStart(spark);
+        spark.Bind(history, 2);
+        tv.Append(history);
+
+        level.Title("Level");
+        level.PackStart(bar);
+        bar.Bind(level, 1);
+        tv.Append(level);
+
+        tv.Model(store);
+        sw.Child(tv);
+        win.Child(sw);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(100, &MyApp::update, this);
+    }
+    bool update() {
+        ++tick;
+        int row = 0;
+        for (gtk::TreeIter it = store.First(); row < ROWS; store.Next(it), ++row) {
+            Series &s = series[row];
+            double v = 0.5 + 0.45 * sin(tick * 0.1 + row * 0.3) * cos(tick * 0.03 * (row % 7 + 1));
+            s.erase(s.begin());
+            s.push_back(v);
+            store.Set(it, 1, v, -1);
+        }
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
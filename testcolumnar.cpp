@@ -0,0 +1,87 @@
+// a TreeView showing a couple of million rows stored in a ColumnarModel
+#include "oomodel.h"
+#include <stdio.h>
+
+#define ROWS 2000000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::ColumnarModel model;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    int sells;
+public:
+    MyApp() : win("Test ColumnarModel"),
+              model(make_vector(G_TYPE_INT)(G_TYPE_STRING)(G_TYPE_DOUBLE)(G_TYPE_BOOLEAN)), sells(0) {
+        static const char *symbols[] = { "AAPL", "MSFT", "GOOG", "AMZN", "INTC", "ORCL" };
+        char side[16];
+
+        gint64 start = g_get_monotonic_time();
+
+        // fill the model before attaching it to the view, the row setters don't emit signals
+        model.Reserve(ROWS);
+        int first = model.AppendRows(ROWS);
+        for (int i = 0; i < ROWS; ++i) {
+            g_snprintf(side, sizeof(side), "%s %s", i % 3 ? "BUY" : "SELL", symbols[i % 6]);
+            model.SetValue(first + i, 0, i);
+            model.SetValue(first + i, 1, side);
+            model.SetValue(first + i, 2, 100.0 + (i % 1000) / 100.0);
+            model.SetValue(first + i, 3, (i % 7) == 0);
+        }
+        gint64 loaded = g_get_monotonic_time();
+
+        tv.AddTextColumn("Id", 0);
+        tv.AddTextColumn("Order", 1);
+        // the price is formatted while drawing, the model keeps only the double, CellData()
+        // drops the "text" attribute so GTK doesn't convert the double to a string first
+        if (gtk::TreeViewColumn *c = tv.AddTextColumn("Price", 2, gtk::TextPlain)) {
+            gtk::RendererList renderers;
+            c->GetRenderers(renderers);
+            c->CellData(*renderers.front(), 2, &MyApp::price, this);
+        }
+        tv.AddBooleanColumn("Filled", 3);
+        tv.Model(model);
+
+        std::cerr << ROWS << " rows loaded in " << (loaded - start) / 1000 << "ms, attached in "
+                  << (g_get_monotonic_time() - loaded) / 1000 << "ms\n";
+
+        // the strings of a ColumnarModel are read in place, std::string copies every cell
+        gint64 scan = g_get_monotonic_time();
+        model.VisitColumn(1, &MyApp::count, this);
+        gint64 visited = g_get_monotonic_time();
+        std::string order;
+        int copies = 0;
+        gtk::TreeIter it = model.First();
+        do {
+            model.GetValue(it, 1, order);
+            if (order.compare(0, 4, "SELL") == 0)
+                ++copies;
+        } while (model.Next(it));
+        std::cerr << sells << " sell orders visited in " << (visited - scan) / 1000 << "ms, "
+                  << copies << " read as std::string in " << (g_get_monotonic_time() - visited) / 1000 << "ms\n";
+
+        sw.Child(tv);
+        win.Child(sw);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    bool count(const gtk::TreeIter &, const char *order) {
+        if (order && !strncmp(order, "SELL", 4))
+            ++sells;
+        return true;
+    }
+    void price(double value, gtk::CellFormat &out) {
+        out.Printf("%.2f $", value);
+        if (value >= 109.0)
+            out.Foreground("red");
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
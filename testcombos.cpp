@@ -0,0 +1,57 @@
+// fills a form of 200 combos with the same 5000 choices, with Append(), with Assign() and sharing a StringList
+#include "oogtk.h"
+#include "oomodel.h"
+
+#define COMBOS 200
+#define CHOICES 5000
+#define PER_ROW 10
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::Table table;
+    gtk::ComboBoxText combos[COMBOS];
+    std::vector<std::string> choices;
+public:
+    MyApp() : win("Test ComboBoxText::Assign"), table(COMBOS / PER_ROW, PER_ROW) {
+        for (int i = 0; i < CHOICES; ++i) {
+            char name[32];
+            g_snprintf(name, sizeof(name), "choice %04d", i);
+            choices.push_back(name);
+        }
+        for (int i = 0; i < COMBOS; ++i)
+            table.Attach(combos[i], i % PER_ROW, i / PER_ROW);
+
+        gint64 start = g_get_monotonic_time();
+        for (int i = 0; i < COMBOS; ++i)
+            for (int j = 0; j < CHOICES; ++j)
+                combos[i].Append(choices[j]);
+        std::cerr << "Append: " << (g_get_monotonic_time() - start) / 1000 << "ms\n";
+
+        start = g_get_monotonic_time();
+        for (int i = 0; i < COMBOS; ++i)
+            combos[i].Assign(choices);
+        std::cerr << "Assign: " << (g_get_monotonic_time() - start) / 1000 << "ms\n";
+
+        start = g_get_monotonic_time();
+        {
+            gtk::StringList shared(choices);
+            for (int i = 0; i < COMBOS; ++i) {
+                combos[i].Model(shared);
+                combos[i].Active(shared.Find("choice 0042"));
+            }
+        }
+        std::cerr << "shared StringList: " << (g_get_monotonic_time() - start) / 1000 << "ms\n";
+
+        win.Child(table);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,87 @@
+// refreshes a 10000 rows table every second from a full snapshot, only the differences reach the view
+#include "oogtk.h"
+
+#define ROWS 10000
+
+struct Order {
+    int id;
+    std::string status;
+    double price;
+};
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+    std::vector<Order> orders;
+    int next_id;
+public:
+    MyApp() : win("Test ListStore::Apply"), store(make_vector(G_TYPE_INT)(G_TYPE_STRING)(G_TYPE_DOUBLE)), next_id(0) {
+        for (int i = 0; i < ROWS; ++i)
+            add();
+        refresh();
+
+        tv.AddTextColumn("Id", 0, gtk::TextPlain);
+        tv.AddTextColumn("Status", 1, gtk::TextPlain);
+        tv.AddTextColumn("Price", 2, gtk::TextPlain);
+        tv.Model(store);
+
+        sw.Child(tv);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(1000, &MyApp::tick, this);
+    }
+    void add() {
+        Order o = { next_id++, "open", g_random_double_range(90.0, 110.0) };
+        orders.push_back(o);
+    }
+    // the backend: a few orders change, a few are filled and a few arrive, one moves to the top
+    void simulate() {
+        for (int i = 0; i < 10; ++i) {
+            Order &o = orders[g_random_int_range(0, orders.size())];
+            o.price = g_random_double_range(90.0, 110.0);
+            o.status = "modified";
+        }
+        for (int i = 0; i < 5; ++i)
+            orders.erase(orders.begin() + g_random_int_range(0, orders.size()));
+        for (int i = 0; i < 5; ++i)
+            add();
+        std::swap(orders[0], orders[g_random_int_range(0, orders.size())]);
+    }
+    gtk::ListStore::Changes refresh() {
+        gtk::ListStore::Snapshot snap(store);
+        snap.Reserve(orders.size());
+        for (size_t i = 0; i < orders.size(); ++i) {
+            int row = snap.Add();
+            snap.Set(row, 0, orders[i].id);
+            snap.Set(row, 1, orders[i].status);
+            snap.Set(row, 2, orders[i].price);
+        }
+        return store.Apply(snap, 0);
+    }
+    bool tick() {
+        simulate();
+        gint64 start = g_get_monotonic_time();
+        gtk::ListStore::Changes c = refresh();
+        std::ostringstream os;
+        os << c.inserted << " inserted, " << c.deleted << " deleted, " << c.moved << " moved, " << c.changed
+           << " changed in " << (g_get_monotonic_time() - start) / 1000 << "ms";
+        status.Text(os.str());
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,61 @@
+// a TreeView over a LazyModel, the values are computed only for the rows that are drawn
+#include "oomodel.h"
+#include <math.h>
+
+#define ROWS 50000000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::LazyModel model;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+    int fetched;
+public:
+    MyApp() : win("Test LazyModel"), model(make_vector(G_TYPE_INT)(G_TYPE_STRING), ROWS, 2000), fetched(0) {
+        // set the provider before attaching the model, so no row-changed signal is emitted
+        model.Provider(&MyApp::fetch, this);
+        tv.Model(model);
+
+        tv.FixedHeightMode(true);
+        if (gtk::TreeViewColumn *c = tv.AddTextColumn("Row", 0))
+            c->Sizing(gtk::TreeViewColumn::Fixed);
+        if (gtk::TreeViewColumn *c = tv.AddTextColumn("Square root", 1))
+            c->Sizing(gtk::TreeViewColumn::Fixed);
+
+        sw.Child(tv);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(500, &MyApp::update, this);
+    }
+    // called only for the visible rows
+    void fetch(int row, int col, GValue *value) {
+        char buf[32];
+        ++fetched;
+        if (col == 0)
+            g_value_set_int(value, row);
+        else {
+            g_snprintf(buf, sizeof(buf), "%.6f", sqrt((double)row));
+            g_value_set_string(value, buf);
+        }
+    }
+    bool update() {
+        char buf[80];
+        g_snprintf(buf, sizeof(buf), "%d values fetched, %d cached", fetched, (int)model.Cached());
+        status.Text(buf);
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
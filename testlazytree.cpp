@@ -0,0 +1,68 @@
+// browses a synthetic hierarchy of millions of nodes, loading the children of a row when it's expanded
+#include "oogtk.h"
+
+#define TOP 100000
+#define DIRS 20
+#define FILES 80
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::TreeStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::LazyChildren *lazy;
+public:
+    MyApp() : win("Test LazyChildren"), store(make_vector(G_TYPE_STRING)(G_TYPE_INT)) {
+        tv.AddTextColumn("Name", 0, gtk::TextPlain);
+        tv.AddTextColumn("Size", 1, gtk::TextPlain);
+        tv.Model(store);
+        lazy = new gtk::LazyChildren(store, tv, &MyApp::load, this);
+
+        // the top level is prepared in one subtree, the store is empty so its rows are inserted
+        // at the front from the last one, without walking the 100000 siblings for each row
+        gint64 start = g_get_monotonic_time();
+        gtk::TreeStore::Subtree top(store);
+        char name[32];
+        for (int i = 0; i < TOP; ++i) {
+            int dir = top.Add();
+            g_snprintf(name, sizeof(name), "volume%06d", i);
+            top.Set(dir, 0, name);
+            top.Lazy(dir);
+        }
+        store.InsertSubtree(top, tv);
+        std::cerr << TOP << " lazy rows inserted in " << (g_get_monotonic_time() - start) / 1000 << "ms\n";
+
+        sw.Child(tv);
+        win.Child(sw);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    ~MyApp() { delete lazy; }
+    // every directory holds DIRS lazy directories and FILES files
+    void load(gtk::TreeStore &store, const gtk::TreeIter &parent) {
+        gtk::TreeStore::Subtree entries(store);
+        char name[32];
+        for (int i = 0; i < DIRS; ++i) {
+            int dir = entries.Add();
+            g_snprintf(name, sizeof(name), "dir%02d", i);
+            entries.Set(dir, 0, name);
+            entries.Lazy(dir);
+        }
+        for (int i = 0; i < FILES; ++i) {
+            int file = entries.Add();
+            g_snprintf(name, sizeof(name), "file%02d.txt", i);
+            entries.Set(file, 0, name);
+            entries.Set(file, 1, (i + 1) * 512);
+        }
+        store.InsertSubtree(parent, entries);
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,99 @@
+#include "oogtk.h"
+#include "oothread.h"
+#include "ooqueue.h"
+
+// this program is built with OOGTK_POOL_ALLOC (see the Makefile): worker threads
+// create list stores with a callback connected, half of them are destroyed by the
+// thread that created them and half by a reaper thread, so the wrappers and the
+// callbacks go back to the pool of another thread.
+
+#ifndef OOGTK_POOL_ALLOC
+#error "testpool must be built with -DOOGTK_POOL_ALLOC"
+#endif
+
+#define ROUNDS 20000
+#define WORKERS 4
+
+static bool check(const char *what, bool result) {
+    std::cerr << what << ": " << (result ? "ok" : "WRONG") << "\n";
+    return result;
+}
+
+class Worker : public gtk::Thread {
+    gtk::MPMCQueue<gtk::ListStore *> *reaper_;
+    void inserted() { ++calls; }
+    void worker_thread() {
+        for (int i = 0; i < ROUNDS && Running(); ++i) {
+            gtk::ListStore *store = new gtk::ListStore(make_vector(G_TYPE_INT));
+            store->callback("row-inserted", &Worker::inserted, this);
+            store->Append();
+            if (i % 2)
+                delete store;
+            else
+                reaper_->Push(store);
+        }
+        // a block released by this thread is the next one it gets
+        gtk::ListStore *first = new gtk::ListStore(make_vector(G_TYPE_INT));
+        void *block = first;
+        delete first;
+        gtk::ListStore *second = new gtk::ListStore(make_vector(G_TYPE_INT));
+        recycled = block == second;
+        delete second;
+    }
+public:
+    int calls;
+    bool recycled;
+    Worker(gtk::MPMCQueue<gtk::ListStore *> *q) : Thread("pool worker"), reaper_(q), calls(0), recycled(false) { Start(); }
+};
+
+class Reaper : public gtk::Thread {
+    gtk::MPMCQueue<gtk::ListStore *> *queue_;
+    void worker_thread() {
+        gtk::ListStore *store;
+        while (queue_->Pop(store)) {
+            delete store;
+            ++deleted;
+        }
+    }
+public:
+    int deleted;
+    Reaper(gtk::MPMCQueue<gtk::ListStore *> *q) : Thread("pool reaper"), queue_(q), deleted(0) { Start(); }
+};
+
+int main()
+{
+    gtk::Application::ThreadInit();
+    gtk::Application::Init();
+    bool ok = true;
+
+    // the second pass runs on new threads, they draw the blocks left by the first ones
+    for (int pass = 1; pass <= 2; ++pass) {
+        gtk::MPMCQueue<gtk::ListStore *> q(1024);
+        gint64 start = g_get_monotonic_time();
+        Reaper reaper(&q);
+        Worker *w[WORKERS];
+
+        for (int i = 0; i < WORKERS; ++i)
+            w[i] = new Worker(&q);
+
+        int calls = 0;
+        bool recycled = true;
+        for (int i = 0; i < WORKERS; ++i) {
+            w[i]->Join();
+            calls += w[i]->calls;
+            recycled &= w[i]->recycled;
+            delete w[i];
+        }
+        q.Close();
+        reaper.Join();
+        gint64 elapsed = g_get_monotonic_time() - start;
+
+        std::cerr << "pass " << pass << ": " << ROUNDS * WORKERS << " stores and callbacks in "
+                  << elapsed / 1000 << "ms\n";
+        ok &= check("callbacks called", calls == ROUNDS * WORKERS);
+        ok &= check("stores deleted by the reaper", reaper.deleted == ROUNDS * WORKERS / 2);
+        ok &= check("blocks recycled by the thread", recycled);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "oogtk.h"
+#include "oothread.h"
+#include "ooqueue.h"
+
+// this program moves a stream of integers through the lock free queues,
+// with one producer/consumer pair on a SPSCQueue and a pool of producers
+// and consumers sharing a MPMCQueue.
+
+#define ITEMS 1000000
+#define WORKERS 3
+
+class Producer : public gtk::Thread {
+    gtk::SPSCQueue<int> *spsc_;
+    gtk::MPMCQueue<int> *mpmc_;
+    void worker_thread() {
+        for (int i = 1; i <= ITEMS && Running(); ++i) {
+            if (spsc_)
+                spsc_->Push(i);
+            else
+                mpmc_->Push(i);
+        }
+    }
+public:
+    Producer(gtk::SPSCQueue<int> *q) : Thread("producer"), spsc_(q), mpmc_(NULL) { Start(); }
+    Producer(gtk::MPMCQueue<int> *q) : Thread("producer"), spsc_(NULL), mpmc_(q) { Start(); }
+};
+
+class Consumer : public gtk::Thread {
+    gtk::SPSCQueue<int> *spsc_;
+    gtk::MPMCQueue<int> *mpmc_;
+    void worker_thread() {
+        int v;
+        while (spsc_ ? spsc_->Pop(v) : mpmc_->Pop(v))
+            sum += v;
+    }
+public:
+    long long sum;
+    Consumer(gtk::SPSCQueue<int> *q) : Thread("consumer"), spsc_(q), mpmc_(NULL), sum(0) { Start(); }
+    Consumer(gtk::MPMCQueue<int> *q) : Thread("consumer"), spsc_(NULL), mpmc_(q), sum(0) { Start(); }
+};
+
+int main()
+{
+    gtk::Application::ThreadInit();
+
+    const long long expected = (long long)ITEMS * (ITEMS + 1) / 2;
+    bool ok = true;
+
+    {
+        gtk::SPSCQueue<int> q(1024);
+        gint64 start = g_get_monotonic_time();
+        Consumer c(&q);
+        Producer p(&q);
+        p.Join();
+        q.Close();
+        c.Join();
+        gint64 elapsed = g_get_monotonic_time() - start;
+
+        std::cerr << "SPSC: " << ITEMS << " items in " << elapsed / 1000 << "ms, sum "
+                  << (c.sum == expected ? "ok" : "WRONG") << "\n";
+        ok &= c.sum == expected;
+    }
+    {
+        gtk::MPMCQueue<int> q(1024);
+        gint64 start = g_get_monotonic_time();
+        Consumer *c[WORKERS];
+        Producer *p[WORKERS];
+
+        for (int i = 0; i < WORKERS; ++i)
+            c[i] = new Consumer(&q);
+        for (int i = 0; i < WORKERS; ++i)
+            p[i] = new Producer(&q);
+        for (int i = 0; i < WORKERS; ++i)
+            p[i]->Join();
+        q.Close();
+
+        long long sum = 0;
+        for (int i = 0; i < WORKERS; ++i) {
+            c[i]->Join();
+            sum += c[i]->sum;
+            delete c[i];
+            delete p[i];
+        }
+        gint64 elapsed = g_get_monotonic_time() - start;
+
+        std::cerr << "MPMC: " << ITEMS * WORKERS << " items in " << elapsed / 1000 << "ms, sum "
+                  << (sum == expected * WORKERS ? "ok" : "WRONG") << "\n";
+        ok &= sum == expected * WORKERS;
+    }
+    {
+        gtk::SPSCQueue<int> q(4);
+        int v;
+        gint64 start = g_get_monotonic_time();
+        bool timed_out = !q.Pop(v, 50);
+        gint64 elapsed = g_get_monotonic_time() - start;
+
+        std::cerr << "Timed pop on empty queue " << (timed_out ? "timed out" : "FAILED")
+                  << " after " << elapsed / 1000 << "ms\n";
+        ok &= timed_out;
+    }
+
+    return ok ? 0 : 1;
+}
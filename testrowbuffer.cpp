@@ -0,0 +1,81 @@
+// streams 50000 price updates per second into a ListStore, with and without a RowChangeBuffer
+#include "oogtk.h"
+
+#define ROWS 2000
+#define UPDATES 50
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::CheckButton coalesce;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+    gtk::RowChangeBuffer *buffer;
+    std::vector<gtk::TreeIter> rows;
+    int updates, signals;
+    gint64 start;
+public:
+    MyApp() : win("Test RowChangeBuffer"), coalesce("Coalesce row-changed"),
+              store(make_vector(G_TYPE_STRING)(G_TYPE_DOUBLE)(G_TYPE_INT)), buffer(NULL),
+              updates(0), signals(0), start(g_get_monotonic_time()) {
+        for (int i = 0; i < ROWS; ++i) {
+            char name[16];
+            g_snprintf(name, sizeof(name), "SYM%04d", i);
+            gtk::TreeIter it = store.Append();
+            store.Set(it, 0, name, 1, 100.0, 2, 0, -1);
+            rows.push_back(it);
+        }
+        tv.AddTextColumn("Symbol", 0, gtk::TextPlain);
+        tv.AddTextColumn("Price", 1, gtk::TextPlain);
+        tv.AddTextColumn("Volume", 2, gtk::TextPlain);
+        tv.Model(store);
+        // counts the signals that reach the views
+        g_signal_connect(store.Obj(), "row-changed", GCallback(count), this);
+
+        coalesce.OnClick(&MyApp::toggle, this);
+
+        sw.Child(tv);
+        box.PackStart(coalesce, false);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(1, &MyApp::stream, this);
+        AddTimer(1000, &MyApp::report, this);
+    }
+    ~MyApp() { delete buffer; }
+    static void count(GtkTreeModel *, GtkTreePath *, GtkTreeIter *, MyApp *app) { ++app->signals; }
+    void toggle() {
+        delete buffer;
+        buffer = coalesce.Active() ? new gtk::RowChangeBuffer(store) : NULL;
+    }
+    bool stream() {
+        for (int i = 0; i < UPDATES; ++i) {
+            gtk::TreeIter &it = rows[g_random_int_range(0, ROWS / 10)];
+            store.Set(it, 1, g_random_double_range(90.0, 110.0), 2, g_random_int_range(0, 10000), -1);
+            ++updates;
+        }
+        return true;
+    }
+    bool report() {
+        double secs = (g_get_monotonic_time() - start) / 1000000.0;
+        std::ostringstream os;
+        os << (int)(updates / secs) << " updates/s, " << (int)(signals / secs) << " row-changed/s";
+        status.Text(os.str());
+        updates = signals = 0;
+        start = g_get_monotonic_time();
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
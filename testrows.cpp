@@ -0,0 +1,74 @@
+#include "oogtk.h"
+#include "oomodel.h"
+
+// this program walks a TreeStore and a ColumnarModel with the row ranges
+// and checks the rows they return.
+
+static bool check(const char *what, bool result) {
+    std::cerr << what << ": " << (result ? "ok" : "WRONG") << "\n";
+    return result;
+}
+
+int main() {
+    gtk::Application::Init();
+    bool ok = true;
+
+    // three parents numbered 0, 10, 20 with two children each, numbered parent + 1 and parent + 2
+    gtk::TreeStore store(make_vector(G_TYPE_INT)(G_TYPE_STRING));
+    for (int p = 0; p < 3; ++p) {
+        gtk::TreeIter parent = store.Append();
+        store.Set(parent, 0, p * 10, 1, "parent", -1);
+        for (int c = 1; c <= 2; ++c) {
+            gtk::TreeIter child = store.Append(parent);
+            store.Set(child, 0, p * 10 + c, 1, "child", -1);
+        }
+    }
+
+    std::vector<int> top;
+    for (gtk::TreeModel::Row row : store.Range())
+        top.push_back(row.Get<int>(0));
+    ok &= check("Range()", top == make_vector(0)(10)(20));
+
+    std::vector<int> deep;
+    std::vector<std::string> paths;
+    for (auto row : store.DepthFirst()) {
+        deep.push_back(row.Get<int>(0));
+        paths.push_back(row.Path().str());
+    }
+    ok &= check("DepthFirst()", deep == make_vector(0)(1)(2)(10)(11)(12)(20)(21)(22));
+    ok &= check("DepthFirst() paths", paths.size() == 9 && paths[4] == "1:0" && paths[8] == "2:1");
+
+    gtk::TreeIter second;
+    store.Get(second, "1");
+    std::vector<int> children;
+    for (auto row : store.Range(second))
+        children.push_back(row.Get<int>(0));
+    ok &= check("Range(parent)", children == make_vector(11)(12));
+
+    int under = 0;
+    for (auto row : store.DepthFirst(second))
+        under += row.Get<int>(0);
+    ok &= check("DepthFirst(parent)", under == 23);
+
+    int grandchildren = 0;
+    for (auto row : store.Range())
+        for (auto child : row.Children())
+            grandchildren += child.Get<std::string>(1) == "child";
+    ok &= check("Row::Children()", grandchildren == 6);
+
+    ok &= check("Snapshot<int>()", store.Snapshot<int>(0) == deep);
+
+    // the ranges work on the list models too, their Rows() returns the number of rows
+    gtk::ColumnarModel columnar(make_vector(G_TYPE_INT));
+    int first = columnar.AppendRows(100);
+    for (int r = 0; r < 100; ++r)
+        columnar.SetValue(first + r, 0, r);
+    int sum = 0, count = 0;
+    for (auto row : columnar.Range()) {
+        sum += row.Get<int>(0);
+        ++count;
+    }
+    ok &= check("ColumnarModel::Range()", count == columnar.Rows() && sum == 4950);
+
+    return ok ? 0 : 1;
+}
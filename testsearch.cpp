@@ -0,0 +1,77 @@
+// an entry completing 200000 symbols and a TreeView searching them through a SearchIndex
+#include "oogtk.h"
+#include "oosearch.h"
+
+#define ROWS 200000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::Entry entry;
+    gtk::EntryCompletion completion;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::SearchIndex *prefix, *substring;
+public:
+    MyApp() : win("Test SearchIndex"), store(make_vector(G_TYPE_STRING)) {
+        store.AppendRows(ROWS, &MyApp::fill, this);
+
+        gint64 start = g_get_monotonic_time();
+        prefix = new gtk::SearchIndex(store, 0);
+        gint64 built = g_get_monotonic_time();
+        substring = new gtk::SearchIndex(store, 0, gtk::SearchIndex::Substring);
+        std::cerr << ROWS << " symbols indexed by prefix in " << (built - start) / 1000 << "ms, by trigram in "
+                  << (g_get_monotonic_time() - built) / 1000 << "ms\n";
+
+        start = g_get_monotonic_time();
+        size_t found = substring->Find("widget").size();
+        std::cerr << found << " symbols containing \"widget\" found in "
+                  << (g_get_monotonic_time() - start) / 1000 << "ms\n";
+
+        completion.Model(&store);
+        completion.TextColumn(0);
+        completion.MinimumKeyLength(2);
+        prefix->Attach(completion);
+        entry.Completion(&completion);
+
+        // the interactive search of the view matches anywhere in the symbol
+        tv.AddTextColumn("Symbol", 0);
+        tv.Model(store);
+        tv.EnableSearch(true);
+        substring->Attach(tv);
+
+        // the index follows the changes of the store
+        gtk::TreeIter it = store.First();
+        store.Set(it, 0, "zz_renamed_symbol", -1);
+
+        sw.Child(tv);
+        box.PackStart(entry, false);
+        box.PackStart(sw);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    ~MyApp() {
+        delete prefix;
+        delete substring;
+    }
+    void fill(int row, gtk::RowValues &values) {
+        static const char *modules[] = { "gtk", "gdk", "g", "pango", "cairo", "atk" };
+        static const char *objects[] = { "widget", "window", "tree_view", "list_store", "entry", "layout", "context" };
+        static const char *verbs[] = { "get", "set", "new", "add", "remove", "draw", "show", "find" };
+        char buf[64];
+        g_snprintf(buf, sizeof(buf), "%s_%s_%s_%d", modules[row % 6], objects[(row / 6) % 7],
+                   verbs[(row / 42) % 8], row / 336);
+        values.Set(0, buf);
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,82 @@
+// selects and removes 100000 rows with the bulk operations of TreeSelection and ListStore
+#include "oogtk.h"
+
+#define ROWS 100000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::HBox buttons;
+    gtk::Button odd, remove;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+    int changes;
+public:
+    MyApp() : win("Test bulk selection"), odd("Select odd rows"), remove("Remove selected"),
+              store(make_vector(G_TYPE_INT)(G_TYPE_STRING)), changes(0) {
+        store.AppendRows(ROWS, &MyApp::fill, this);
+        tv.AddTextColumn("Id", 0);
+        tv.AddTextColumn("Name", 1);
+        tv.Model(store);
+        tv.Selection().Mode(gtk::SelectionMultiple);
+        tv.Selection().OnChanged(&MyApp::changed, this);
+
+        odd.OnClick(&MyApp::select_odd, this);
+        remove.OnClick(&MyApp::remove_selected, this);
+
+        sw.Child(tv);
+        buttons.PackStart(odd);
+        buttons.PackStart(remove);
+        box.PackStart(buttons, false);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+    }
+    void fill(int row, gtk::RowValues &values) {
+        char buf[32];
+        g_snprintf(buf, sizeof(buf), "row %d", row);
+        values.Set(0, row);
+        values.Set(1, buf);
+    }
+    void changed() { ++changes; }
+    void report(const char *what, gint64 start) {
+        std::vector<int> rows;
+        tv.Selection().SelectedRows(rows);
+        std::ostringstream os;
+        os << what << " in " << (g_get_monotonic_time() - start) / 1000 << "ms, " << rows.size()
+           << " rows selected, " << changes << " changed signals";
+        status.Text(os.str());
+        changes = 0;
+    }
+    void select_odd() {
+        gint64 start = g_get_monotonic_time();
+        std::vector<int> rows;
+        for (int i = 1; i < store.ChildrenNumber(); i += 2)
+            rows.push_back(i);
+        tv.Selection().SelectRows(rows);
+        report("odd rows selected", start);
+    }
+    void remove_selected() {
+        gint64 start = g_get_monotonic_time();
+        std::vector<int> rows;
+        {
+            gtk::TreeSelection::Batch batch(tv.Selection());
+            tv.Selection().SelectedRows(rows);
+            store.RemoveRows(rows, tv);
+        }
+        report("selected rows removed", start);
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
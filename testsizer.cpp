@@ -0,0 +1,79 @@
+// lays out a 500000 rows view measuring a sample of the rows with a ColumnSizer
+#include "oogtk.h"
+
+#define ROWS 500000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::Button longer;
+    gtk::ListStore store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::ColumnSizer sizer;
+    gint64 start;
+public:
+    MyApp() : win("Test ColumnSizer"), longer("Longer descriptions"),
+              store(make_vector(G_TYPE_INT)(G_TYPE_STRING)(G_TYPE_STRING)(G_TYPE_DOUBLE)),
+              sizer(tv, 200) {
+        store.AppendRows(ROWS, &MyApp::fill, this);
+        tv.AddTextColumn("Id", 0, gtk::TextPlain);
+        tv.AddTextColumn("Name", 1, gtk::TextPlain);
+        tv.AddTextColumn("Description", 2, gtk::TextPlain);
+        tv.AddTextColumn("Value", 3, gtk::TextPlain);
+        tv.Model(store);
+
+        longer.OnClick(&MyApp::lengthen, this);
+
+        sw.Child(tv);
+        box.PackStart(longer, false);
+        box.PackStart(sw);
+        win.Child(box);
+        win.DefaultSize(600, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+
+        // the header buttons are measured too, they exist once the view is realized
+        tv.Realize();
+        start = g_get_monotonic_time();
+        sizer.Measure();
+        std::cerr << "columns measured in " << (g_get_monotonic_time() - start) / 1000 << "ms, fixed height "
+                  << (sizer.FixedHeight() ? "enabled" : "disabled") << "\n";
+
+        start = g_get_monotonic_time();
+        win.ShowAll();
+        g_idle_add(GSourceFunc(shown), this);
+    }
+    static gboolean shown(MyApp *app) {
+        std::cerr << "first layout in " << (g_get_monotonic_time() - app->start) / 1000 << "ms\n";
+        return FALSE;
+    }
+    void fill(int row, gtk::RowValues &values) {
+        char buf[64];
+        values.Set(0, row);
+        g_snprintf(buf, sizeof(buf), "item %d", row);
+        values.Set(1, buf);
+        g_snprintf(buf, sizeof(buf), "description of the item %d", row);
+        values.Set(2, buf);
+        values.Set(3, row * 0.25);
+    }
+    // only the description column is measured again
+    void lengthen() {
+        for (int i = 0; i < 200; ++i) {
+            gtk::TreeIter it;
+            char path[16];
+            g_snprintf(path, sizeof(path), "%d", i * (ROWS / 200));
+            if (store.Get(it, path))
+                store.Set(it, 2, "a much longer description, the column must grow to show it", -1);
+        }
+        sizer.Refresh(*tv.Get(2));
+        std::cerr << "description column is now " << sizer.Width(*tv.Get(2)) << " pixels\n";
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,66 @@
+// a million log lines in a ListStore, sorted and filtered in parallel by a SortFilterModel
+#include "oomodel.h"
+
+#define ROWS 1000000
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::Entry search;
+    gtk::ListStore store;
+    gtk::SortFilterModel *proxy;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+public:
+    MyApp() : win("Test SortFilterModel"), store(make_vector(G_TYPE_INT)(G_TYPE_STRING)) {
+        static const char *levels[] = { "INFO", "WARNING", "ERROR", "DEBUG" };
+        static const char *sources[] = { "network", "database", "scheduler", "cache", "ui" };
+        char buf[96];
+
+        // the store is filled before the proxy is created, so the proxy doesn't see a signal per row
+        for (int i = 0; i < ROWS; ++i) {
+            g_snprintf(buf, sizeof(buf), "%s %s: request %d completed in %dms",
+                       levels[i % 4], sources[(i / 4) % 5], (i * 7919) % ROWS, (i * 31) % 997);
+            store.AddTail(0, i, 1, buf, -1);
+        }
+        proxy = new gtk::SortFilterModel(store);
+
+        tv.AddSortableTextColumn("Line", 0);
+        tv.AddSortableTextColumn("Message", 1);
+        tv.Model(*proxy);
+
+        search.OnChanged(&MyApp::filter, this);
+        sw.Child(tv);
+        box.PackStart(search, false);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(600, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(50, &MyApp::update, this);
+    }
+    ~MyApp() { delete proxy; }
+    void filter() {
+        proxy->Filter(1, search.Get());
+    }
+    bool update() {
+        char buf[80];
+        if (proxy->Busy())
+            status.Text("filtering...");
+        else {
+            g_snprintf(buf, sizeof(buf), "%d lines shown", proxy->Rows());
+            status.Text(buf);
+        }
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
@@ -0,0 +1,74 @@
+// compares the scroll speed of a 40 columns grid bound to "markup" and to "text"
+#include "oogtk.h"
+
+#define ROWS 20000
+#define COLUMNS 40
+#define STEPS 200
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::HBox box;
+    gtk::ListStore store;
+    gtk::TreeView markup, plain;
+    gtk::ScrolledWindow msw, psw;
+public:
+    MyApp() : win("Test text columns"), store(gtk::TypeList(COLUMNS, G_TYPE_STRING)) {
+        store.AppendRows(ROWS, &MyApp::fill, this);
+
+        // the first column of the plain grid is bold, without markup in the cells
+        PangoAttrList *bold = pango_attr_list_new();
+        pango_attr_list_insert(bold, pango_attr_weight_new(PANGO_WEIGHT_BOLD));
+        for (int i = 0; i < COLUMNS; ++i) {
+            char title[16];
+            g_snprintf(title, sizeof(title), "C%d", i);
+            markup.AddTextColumn(title, i);
+            gtk::TreeViewColumn *c = plain.AddTextColumn(title, i, gtk::TextPlain);
+            if (i == 0)
+                c->TextAttributes(bold);
+        }
+        pango_attr_list_unref(bold);
+        markup.Model(store);
+        plain.Model(store);
+
+        msw.Child(markup);
+        psw.Child(plain);
+        box.PackStart(msw);
+        box.PackStart(psw);
+        win.Child(box);
+        win.DefaultSize(1000, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(1000, &MyApp::bench, this);
+    }
+    void fill(int row, gtk::RowValues &values) {
+        char buf[32];
+        for (int i = 0; i < COLUMNS; ++i) {
+            g_snprintf(buf, sizeof(buf), "%d.%02d", row, i);
+            values.Set(i, buf);
+        }
+    }
+    // scrolls the view a page at a time, drawing it synchronously
+    double scroll(gtk::TreeView &tv) {
+        GdkWindow *bin = gtk_tree_view_get_bin_window(tv);
+        gint64 start = g_get_monotonic_time();
+        for (int i = 0; i < STEPS; ++i) {
+            gtk_tree_view_scroll_to_point(tv, -1, i * 400);
+            gdk_window_process_updates(bin, TRUE);
+        }
+        return STEPS * 1000000.0 / (g_get_monotonic_time() - start);
+    }
+    bool bench() {
+        double m = scroll(markup);
+        double p = scroll(plain);
+        std::cerr << "markup: " << m << " pages/s, text: " << p << " pages/s\n";
+        return false;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}
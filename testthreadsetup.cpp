@@ -0,0 +1,119 @@
+#include "oogtk.h"
+#include "oothread.h"
+
+// this program starts a thread pinned to a CPU with a low priority and a name,
+// then changes its settings while it runs, and checks what the OS reports.
+
+static bool check(const char *what, bool result) {
+    std::cerr << what << ": " << (result ? "ok" : "WRONG") << "\n";
+    return result;
+}
+
+class Probe : public gtk::Thread {
+    gtk::Mutex mutex_;
+    std::string os_name_;
+    int cpus_;
+    int cpu_;
+    int nice_;
+    bool asked_;
+    void worker_thread() {
+        while (Running()) {
+            {
+                gtk::AutoMutex lock(mutex_);
+                if (asked_) {
+                    read();
+                    asked_ = false;
+                }
+            }
+            USleep(1000);
+        }
+    }
+    // mutex_ must be locked
+    void read() {
+#ifdef __linux__
+        char name[16];
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        os_name_ = name;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        sched_getaffinity(0, sizeof(set), &set);
+        cpus_ = CPU_COUNT(&set);
+        cpu_ = -1;
+        for (int i = 0; i < CPU_SETSIZE && cpu_ < 0; ++i)
+            if (CPU_ISSET(i, &set))
+                cpu_ = i;
+
+        nice_ = getpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid));
+#endif
+    }
+public:
+    Probe() : Thread("acquisition thread 1"), cpus_(0), cpu_(-1), nice_(0), asked_(false) {}
+    // asks the thread to read its own settings and waits for them
+    void Ask(std::string &name, int &cpus, int &cpu, int &nice) {
+        {
+            gtk::AutoMutex lock(mutex_);
+            asked_ = true;
+        }
+        for (;;) {
+            USleep(1000);
+            gtk::AutoMutex lock(mutex_);
+            if (!asked_) {
+                name = os_name_;
+                cpus = cpus_;
+                cpu = cpu_;
+                nice = nice_;
+                return;
+            }
+        }
+    }
+};
+
+int main()
+{
+    gtk::Application::ThreadInit();
+    bool ok = true;
+
+#ifdef __linux__
+    // the CPUs the process may use, the probe is pinned to the last one
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    int last = -1;
+    for (int i = 0; i < CPU_SETSIZE; ++i)
+        if (CPU_ISSET(i, &allowed))
+            last = i;
+    std::string name;
+    int cpus, cpu, nice;
+
+    Probe probe;
+    ok &= check("affinity set before Start()", probe.Affinity(last));
+    ok &= check("priority set before Start()", probe.Priority(gtk::ThreadPriorityLow));
+    ok &= check("Priority()", probe.Priority() == gtk::ThreadPriorityLow);
+    ok &= check("Affinity()", probe.Affinity() == gtk::CpuSet(1, last));
+    probe.Start();
+
+    probe.Ask(name, cpus, cpu, nice);
+    std::cerr << "started as \"" << name << "\" on " << cpus << " CPU(s) from " << cpu << ", nice " << nice << "\n";
+    ok &= check("name truncated to 15 characters", name == "acquisition thr");
+    ok &= check("pinned before worker_thread()", cpus == 1 && cpu == last);
+    ok &= check("low priority before worker_thread()", nice == 10);
+
+    probe.Name("acq");
+    ok &= check("affinity while running", probe.Affinity(gtk::CpuSet()));
+    ok &= check("priority while running", probe.Priority(gtk::ThreadPriorityIdle));
+    ok &= check("Priority() while running", probe.Priority() == gtk::ThreadPriorityIdle);
+
+    probe.Ask(name, cpus, cpu, nice);
+    std::cerr << "running as \"" << name << "\" on " << cpus << " CPU(s) from " << cpu << ", nice " << nice << "\n";
+    ok &= check("renamed", name == "acq");
+    ok &= check("unpinned", cpus == CPU_COUNT(&allowed));
+    ok &= check("idle priority", nice == 19);
+
+    probe.Terminate();
+#else
+    std::cerr << "the OS settings are checked only on linux\n";
+#endif
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+// shows the thumbnails of the images of a folder (the first argument, /usr/share/pixmaps by default) with a ThumbnailLoader
+#include "oogtk.h"
+#include "oothumb.h"
+
+#define SIZE 96
+#define CACHE (16 * 1024 * 1024)
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    gtk::VBox box;
+    gtk::ListStore store;
+    gtk::IconView icons;
+    gtk::ScrolledWindow sw;
+    gtk::Label status;
+    gtk::WorkerPool pool;
+    gtk::ThumbnailLoader *thumbs;
+public:
+    MyApp(int &argc, char **&argv) : gtk::Application(argc, argv), win("Test ThumbnailLoader"), store(make_vector(G_TYPE_STRING)(G_TYPE_STRING)), icons(store) {
+        const char *folder = argc > 1 ? argv[1] : "/usr/share/pixmaps";
+        if (GDir *dir = g_dir_open(folder, 0, NULL)) {
+            while (const gchar *name = g_dir_read_name(dir)) {
+                gchar *path = g_build_filename(folder, name, NULL);
+                if (g_file_test(path, G_FILE_TEST_IS_REGULAR)) {
+                    gtk::TreeIter it = store.Append();
+                    store.Set(it, 0, path, 1, name, -1);
+                }
+                g_free(path);
+            }
+            g_dir_close(dir);
+        }
+        icons.TextColumn(1);
+        icons.ItemWidth(SIZE + 24);
+        thumbs = new gtk::ThumbnailLoader(icons, 0, pool, SIZE, CACHE);
+
+        sw.Child(icons);
+        box.PackStart(sw);
+        box.PackEnd(status, false);
+        win.Child(box);
+        win.DefaultSize(800, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(500, &MyApp::report, this);
+    }
+    ~MyApp() { delete thumbs; }
+    bool report() {
+        std::ostringstream os;
+        os << thumbs->Cached() << " thumbnails cached in " << thumbs->CacheBytes() / 1024 << "KB, "
+           << thumbs->Pending() << " waiting";
+        status.Text(os.str());
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main(int argc, char *argv[])
+{
+    MyApp app(argc, argv);
+    app.Run();
+}
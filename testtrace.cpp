@@ -0,0 +1,66 @@
+#include "oogtk.h"
+#include "oothread.h"
+
+// this program writes trace records from a few threads at a rate the flusher
+// can follow, then checks that every record reached the sink.
+
+#define RECORDS 20000
+#define WORKERS 4
+
+static int lines = 0, dropped = 0;
+
+// the sink is called only by the thread that is flushing
+static void count(const char *line, size_t length)
+{
+    if (strstr(line, "trace records dropped"))
+        ++dropped;
+    else if (strstr(line, "record "))
+        ++lines;
+    if (lines < 4)
+        fwrite(line, 1, length, stderr);
+}
+
+class Writer : public gtk::Thread {
+    int idx_;
+    void worker_thread() {
+        for (int i = 0; i < RECORDS && Running(); ++i) {
+            OOGTK_TRACE(gtk::TraceWarning, "record %d from writer %d: %s", i, idx_, Name());
+            if (i % 64 == 63)
+                g_usleep(1000);
+        }
+    }
+public:
+    Writer(int i) : Thread("writer"), idx_(i) { Start(); }
+};
+
+int main()
+{
+    gtk::Application::ThreadInit();
+    gtk::Trace::SetSink(count);
+
+    gint64 start = g_get_monotonic_time();
+    for (int i = 0; i < 256; ++i)
+        OOGTK_TRACE(gtk::TraceWarning, "record %d from main, %.1f%% done", i, i / 2.56);
+    gint64 elapsed = g_get_monotonic_time() - start;
+    std::cerr << "256 records written in " << elapsed << "us\n";
+
+    // compiled out unless OOGTK_DEBUG is defined
+    OOGTK_TRACE(gtk::TraceDebug, "record %s", "debug");
+
+    std::vector<Writer *> writers;
+    for (int i = 0; i < WORKERS; ++i)
+        writers.push_back(new Writer(i));
+    for (int i = 0; i < WORKERS; ++i) {
+        writers[i]->Join();
+        delete writers[i];
+    }
+    gtk::Trace::Flush();
+
+    int expected = 256 + WORKERS * RECORDS;
+#if OOGTK_TRACE_LEVEL >= 4
+    ++expected;
+#endif
+    std::cerr << lines << " records flushed, " << dropped << " drops reported, "
+              << (lines == expected && !dropped ? "ok" : "WRONG") << "\n";
+    return lines == expected && !dropped ? 0 : 1;
+}
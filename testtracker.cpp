@@ -0,0 +1,56 @@
+// keeps 50000 bookmarks on a 500000 rows store with a RowTracker and with TreeRowReferences
+#include "oogtk.h"
+
+#define ROWS 500000
+#define MARKS 50000
+#define CHANGES 1000
+
+// inserts and deletes CHANGES rows at the top of the store
+static double churn(gtk::ListStore &store) {
+    gint64 start = g_get_monotonic_time();
+    for (int i = 0; i < CHANGES; ++i) {
+        gtk::TreeIter it = store.Insert(0);
+        store.Remove(it);
+    }
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+struct Filler {
+    void fill(int row, gtk::RowValues &values) { values.Set(0, row); }
+};
+
+int main(int argc, char *argv[]) {
+    gtk::Application::Init(argc, argv);
+    Filler filler;
+    gtk::ListStore store(make_vector(G_TYPE_INT));
+    store.AppendRows(ROWS, &Filler::fill, &filler);
+
+    std::cerr << CHANGES << " rows inserted and deleted without bookmarks in " << churn(store) << "ms\n";
+
+    {
+        gtk::RowTracker bookmarks(store);
+        std::vector<gtk::RowTracker::Handle> marks;
+        for (int i = 0; i < MARKS; ++i)
+            marks.push_back(bookmarks.Track(i * (ROWS / MARKS)));
+        std::cerr << CHANGES << " rows inserted and deleted with " << MARKS << " tracked rows in " << churn(store) << "ms\n";
+
+        // a deleted row invalidates its handle, the next ones move up
+        gtk::TreeIter it;
+        store.Get(it, "0");
+        store.Remove(it);
+        gtk::TreeIter second;
+        bookmarks.Resolve(marks[1], second);
+        std::cerr << "first bookmark " << (bookmarks.Valid(marks[0]) ? "valid" : "deleted")
+                  << ", second at row " << bookmarks.Position(marks[1]) << " value " << gtk::TreeModel::Row(store, second).Get<int>(0) << "\n";
+    }
+    {
+        gtk::RefVec refs;
+        for (int i = 0; i < MARKS / 10; ++i) {
+            char path[16];
+            g_snprintf(path, sizeof(path), "%d", i * (ROWS / MARKS));
+            refs.push_back(gtk::TreeRowReference(store, gtk::TreePath(path)));
+        }
+        std::cerr << CHANGES << " rows inserted and deleted with " << MARKS / 10 << " TreeRowReference in " << churn(store) << "ms\n";
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "oogtk.h"
+
+// this program applies the same random operations to a gtk::TreePath and to a
+// GtkTreePath and checks that they always agree: paths grow past the indices kept
+// inline and shrink back, are copied, moved and handed to GTK, that may change them.
+
+#define STEPS 200000
+#define MAX_DEPTH (3 * gtk::TreePath::Inline)
+
+enum { OpAppend, OpPrepend, OpUp, OpDown, OpNext, OpPred, OpCopy, OpMove, OpNative, OpAssign, OpString, OpCompare, Ops };
+static const char *names[Ops] = { "Append()", "Prepend()", "Up()", "Down()", "Next()", "Pred()", "copy", "move",
+                                  "GtkTreePath changed by GTK", "assignment from GtkTreePath", "string", "comparison" };
+
+static bool check(const char *what, bool result) {
+    std::cerr << what << ": " << (result ? "ok" : "WRONG") << "\n";
+    return result;
+}
+
+static bool same(const gtk::TreePath &p, GtkTreePath *g) {
+    int depth = gtk_tree_path_get_depth(g);
+    if (p.Depth() != depth)
+        return false;
+    const int *indices = gtk_tree_path_get_indices(g);
+    for (int i = 0; i < depth; ++i)
+        if (p[i] != indices[i])
+            return false;
+    gchar *s = gtk_tree_path_to_string(g);
+    bool ok = p.str() == (s ? s : "");
+    g_free(s);
+    return ok;
+}
+
+int main()
+{
+    GRand *rand = g_rand_new_with_seed(42);
+    gtk::TreePath p, other;
+    GtkTreePath *g = gtk_tree_path_new();
+    int wrong[Ops] = { 0 };
+    int heap = 0;
+    bool shrinking = false;
+
+    for (int step = 0; step < STEPS; ++step) {
+        int op = g_rand_int_range(rand, 0, Ops);
+        int depth = gtk_tree_path_get_depth(g);
+        int idx = g_rand_int_range(rand, 0, 100);
+
+        // grows up to MAX_DEPTH and shrinks back to 0, across the inline size
+        if (depth >= MAX_DEPTH)
+            shrinking = true;
+        else if (depth == 0)
+            shrinking = false;
+        if (shrinking && (op == OpAppend || op == OpPrepend || op == OpDown || op == OpNative))
+            op = OpUp;
+        if (depth == 0 && (op == OpNext || op == OpPred))
+            op = OpDown;
+
+        switch (op) {
+            case OpAppend:
+                p.Append(idx);
+                gtk_tree_path_append_index(g, idx);
+                break;
+            case OpPrepend:
+                p.Prepend(idx);
+                gtk_tree_path_prepend_index(g, idx);
+                break;
+            case OpUp:
+                p.Up();
+                gtk_tree_path_up(g);
+                break;
+            case OpDown:
+                p.Down();
+                gtk_tree_path_down(g);
+                break;
+            case OpNext:
+                ++p;
+                gtk_tree_path_next(g);
+                break;
+            case OpPred:
+                --p;
+                gtk_tree_path_prev(g);
+                break;
+            case OpCopy: {
+                gtk::TreePath copy(p);
+                wrong[op] += !same(copy, g);
+                copy.Append(idx); // the copy doesn't share the indices
+                p = copy;
+                p.Up();
+                const gtk::TreePath &self = p;
+                p = self;
+                break;
+            }
+            case OpMove: {
+                gtk::TreePath moved(std::move(p));
+                wrong[op] += !same(moved, g);
+                p = std::move(moved);
+                break;
+            }
+            case OpNative: {
+                // GTK changes the path in place, the next call of the wrapper sees the change
+                GtkTreePath *native = p;
+                wrong[op] += gtk_tree_path_get_depth(native) != depth || (depth && gtk_tree_path_compare(native, g) != 0);
+                gtk_tree_path_append_index(native, idx);
+                gtk_tree_path_append_index(g, idx);
+                break;
+            }
+            case OpAssign:
+                p = other;
+                p = *g;
+                break;
+            case OpString:
+                p = gtk::TreePath(p.str());
+                break;
+            case OpCompare: {
+                // gtk_tree_path_compare() doesn't accept empty paths
+                if (depth && other.Depth()) {
+                    GtkTreePath *o = gtk_tree_path_new_from_string(other.str().c_str());
+                    int c = gtk_tree_path_compare(g, o);
+                    wrong[op] += (p < other) != (c < 0) || (p == other) != (c == 0) ||
+                                 p.IsAncestor(other) != (bool)gtk_tree_path_is_ancestor(g, o) ||
+                                 p.IsDescendant(other) != (bool)gtk_tree_path_is_descendant(g, o);
+                    gtk_tree_path_free(o);
+                }
+                other = p;
+                break;
+            }
+        }
+        wrong[op] += !same(p, g);
+        heap += p.Depth() > gtk::TreePath::Inline;
+    }
+
+    bool ok = check("paths deeper than the inline indices", heap > STEPS / 10);
+    for (int op = 0; op < Ops; ++op)
+        ok &= check(names[op], wrong[op] == 0);
+
+    gtk_tree_path_free(g);
+    g_rand_free(rand);
+    return ok ? 0 : 1;
+}
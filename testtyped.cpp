@@ -0,0 +1,53 @@
+// a TypedListStore updated in a timer, the row values are checked at compile time
+#include "ootyped.h"
+
+enum { Name, Count, Ratio, Active };
+typedef gtk::TypedListStore<std::string, int, double, bool> Counters;
+
+class MyApp : public gtk::Application
+{
+    gtk::Window win;
+    Counters store;
+    gtk::TreeView tv;
+    gtk::ScrolledWindow sw;
+    std::vector<gtk::TreeIter> rows;
+public:
+    MyApp() : win("Test TypedListStore") {
+        char buf[32];
+        for (int i = 0; i < 100; ++i) {
+            g_snprintf(buf, sizeof(buf), "counter %d", i);
+            rows.push_back(store.Append(buf, 0, 0.0, i % 2 == 0));
+        }
+        tv.Model(store);
+        tv.AddTextColumn("Name", Name);
+        tv.AddTextColumn("Count", Count);
+        tv.AddTextColumn("Ratio", Ratio);
+        tv.AddBooleanColumn("Active", Active);
+
+        sw.Child(tv);
+        win.Child(sw);
+        win.DefaultSize(400, 600);
+        win.OnDelete(&MyApp::quit, this, true);
+        win.ShowAll();
+        AddTimer(100, &MyApp::update, this);
+    }
+    bool update() {
+        for (size_t i = 0; i < rows.size(); ++i) {
+            Counters::Row r = store[rows[i]];
+            if (!r.Get<Active>())
+                continue;
+            int count = r.Get<Count>() + (int)i;
+            // store.Set<Count>(rows[i], "x") would not compile
+            store.Set<Count>(rows[i], count);
+            store.Set<Ratio>(rows[i], count / 100.0);
+        }
+        return true;
+    }
+    void quit() { Quit(); }
+};
+
+int main()
+{
+    MyApp app;
+    app.Run();
+}